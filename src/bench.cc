@@ -0,0 +1,459 @@
+/*
+ * bench: micro-benchmarks of the trend hot paths
+ * Copyright(c) 2018 by wave++ "Yuri D'Elia" <wavexx@thregr.org>
+ * Distributed under GNU LGPL WITHOUT ANY WARRANTY.
+ */
+
+/*
+ * Headers
+ */
+
+// defaults
+#include "defaults.hh"
+#include "parser.hh"
+#include "input.hh"
+#include "geom.hh"
+#include "timer.hh"
+#include "rr.hh"
+#include "spectrum.hh"
+using Trend::Value;
+
+// system headers
+#include <algorithm>
+#include <string>
+using std::string;
+
+#include <vector>
+using std::vector;
+
+// c system headers
+#include <math.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+
+/*
+ * Benchmark state
+ */
+
+namespace
+{
+  // settings
+  const char* filter = NULL;
+  double minTime = .05;
+  int runs = 5;
+
+  // synthetic data
+  uint64_t seed;
+  vector<Value> values;
+  vector<char> text;
+  vector<char> binary;
+
+  // results are accumulated here to keep the work from being optimized out
+  volatile double sink;
+}
+
+
+/*
+ * Synthetic data
+ */
+
+// xorshift64*: the same sequence for every run and platform
+double
+random01()
+{
+  seed ^= seed >> 12;
+  seed ^= seed << 25;
+  seed ^= seed >> 27;
+  return (seed * 2685821657736338717ULL >> 11) * (1. / 9007199254740992.);
+}
+
+
+// a noisy sine with the given density of undefined values
+void
+genValues(size_t n, double nan)
+{
+  seed = 88172645463325252ULL;
+  values.resize(n);
+  for(size_t i = 0; i != n; ++i)
+    values[i] = (random01() < nan? NAN:
+	sin(i * .01) * 100. + random01() * 10.);
+}
+
+
+// ascii (one frame per line) or binary representation of values
+void
+genInput(Trend::format_t format, size_t graphs)
+{
+  text.clear();
+  binary.clear();
+  char buf[Trend::maxNumLen];
+
+  for(size_t i = 0; i != values.size(); ++i)
+  {
+    switch(format)
+    {
+    case Trend::f_ascii:
+      {
+	int n = snprintf(buf, sizeof(buf), "%.6g", values[i]);
+	text.insert(text.end(), buf, buf + n);
+	text.push_back((i + 1) % graphs? ' ': '\n');
+      }
+      break;
+
+    case Trend::f_named:
+      {
+	int n = snprintf(buf, sizeof(buf), "g%lu=%.6g",
+	    static_cast<unsigned long>(i % graphs), values[i]);
+	text.insert(text.end(), buf, buf + n);
+	text.push_back((i + 1) % graphs? ' ': '\n');
+      }
+      break;
+
+    case Trend::f_float:
+      {
+	float v = values[i];
+	const char* p = reinterpret_cast<const char*>(&v);
+	binary.insert(binary.end(), p, p + sizeof(v));
+      }
+      break;
+
+    default:
+      {
+	const char* p = reinterpret_cast<const char*>(&values[i]);
+	binary.insert(binary.end(), p, p + sizeof(Value));
+      }
+    }
+  }
+}
+
+
+/*
+ * Measurement
+ */
+
+// run fn() as many times as needed to fill minTime, "runs" times, and print
+// the median (and range) of the time per item (ns) in key=value form
+template<class Fn> void
+measure(const string& name, const string& params, size_t items, Fn& fn)
+{
+  if(filter && name.compare(0, strlen(filter), filter))
+    return;
+
+  // calibrate
+  size_t reps = 1;
+  for(;;)
+  {
+    uint64_t start = monotonic();
+    for(size_t i = 0; i != reps; ++i) fn();
+    if((monotonic() - start) / 1e9 >= minTime / 4) break;
+    reps *= 2;
+  }
+  reps *= 4;
+
+  vector<double> times;
+  for(int r = 0; r != runs; ++r)
+  {
+    uint64_t start = monotonic();
+    for(size_t i = 0; i != reps; ++i) fn();
+    times.push_back(static_cast<double>(monotonic() - start) / reps / items);
+  }
+  std::sort(times.begin(), times.end());
+
+  printf("bench=%s %s items=%lu ns=%.3f min=%.3f max=%.3f\n", name.c_str(),
+      params.c_str(), static_cast<unsigned long>(items), times[runs / 2],
+      times.front(), times.back());
+  fflush(stdout);
+}
+
+
+const char*
+formatName(Trend::format_t format)
+{
+  switch(format)
+  {
+  case Trend::f_ascii: return "ascii";
+  case Trend::f_float: return "float";
+  case Trend::f_double: return "double";
+  case Trend::f_named: return "named";
+  default: return "other";
+  }
+}
+
+
+/*
+ * Benchmarks
+ */
+
+// parsing and pushing to the rings, in chunks as read by Stream
+struct ParseBench
+{
+  static void notify(uint64_t) {}
+  static void relabel(size_t, const string&) {}
+  static bool command(const Command&) { return true; }
+  static void control(const char*, size_t, string&) {}
+
+  Trend::format_t format;
+  vector<rr<Value>*> rings;
+  Router* router;
+  Stats stats;
+  Profile profile;
+  Hooks hooks;
+
+  ParseBench(Trend::format_t format, size_t graphs, size_t history)
+  : format(format), router(NULL)
+  {
+    for(size_t i = 0; i != graphs; ++i)
+      rings.push_back(new rr<Value>(history));
+    if(format == Trend::f_named)
+      router = new Router(0, vector<string>(graphs), relabel);
+
+    memset(&stats, 0, sizeof(stats));
+    Hooks h = {notify, relabel, command, control, &stats, &profile};
+    hooks = h;
+  }
+
+  ~ParseBench()
+  {
+    for(size_t i = 0; i != rings.size(); ++i)
+      delete rings[i];
+    delete router;
+  }
+
+  void
+  operator()()
+  {
+    Parser parser(format);
+    Feed feed(&rings[0], 0, rings.size(), Trend::absolute, false, &hooks,
+	router);
+
+    const vector<char>& in = (text.size()? text: binary);
+    for(size_t p = 0; p < in.size(); p += Trend::readSize)
+    {
+      size_t n = std::min(in.size() - p,
+	  static_cast<size_t>(Trend::readSize));
+      feed.parse(parser, &in[p], &in[p] + n);
+      feed.commit();
+    }
+    parser.flush(feed);
+  }
+};
+
+
+struct PushBench
+{
+  rr<Value> ring;
+
+  PushBench(size_t history)
+  : ring(history)
+  {}
+
+  void
+  operator()()
+  {
+    for(size_t i = 0; i != values.size(); ++i)
+      ring.push_back(values[i]);
+  }
+};
+
+
+struct CopyBench
+{
+  rr<Value> ring;
+  vector<Value> buf;
+
+  CopyBench(size_t history)
+  : ring(history), buf(history)
+  {
+    for(size_t i = 0; i != history + history / 3; ++i)
+      ring.push_back(values[i % values.size()]);
+  }
+
+  void
+  operator()()
+  {
+    sink = ring.copy(&buf[0]);
+  }
+};
+
+
+struct RangeBench
+{
+  void
+  operator()()
+  {
+    Value lo = values[0];
+    Value hi = lo;
+    valueRange(&values[0], &values[0] + values.size(), lo, hi);
+    sink = hi - lo;
+  }
+};
+
+
+struct DistribBench
+{
+  vector<double> bins;
+
+  DistribBench(int height)
+  : bins(height)
+  {}
+
+  void
+  operator()()
+  {
+    sink = integrate(&values[0], &values[0] + values.size(), -100., 110.,
+	bins.size(), &bins[0]);
+  }
+};
+
+
+struct LineBench
+{
+  // count the vertexes instead of drawing
+  struct Out
+  {
+    size_t n;
+    double sum;
+
+    void shade(double alpha) { sum += alpha; }
+    void strip() {}
+    void lines() {}
+    void vertex(double x, double y) { ++n; sum += x; }
+    void end() {}
+  };
+
+  LineSpec spec;
+
+  LineBench(size_t history)
+  {
+    LineSpec s = {history, 0, history, history, false, false};
+    spec = s;
+  }
+
+  void
+  operator()()
+  {
+    Out out = {0, 0.};
+    walkLine(&values[0], &values[0] + values.size(), spec, out);
+    sink = out.sum + out.n;
+  }
+};
+
+
+struct FFTBench
+{
+  FFT fft;
+  vector<float> in;
+  vector<float> power;
+
+  FFTBench(size_t size)
+  : fft(size), in(values.begin(), values.begin() + size), power(fft.bins())
+  {}
+
+  void
+  operator()()
+  {
+    fft.power(&in[0], &power[0]);
+    sink = power[1];
+  }
+};
+
+
+/*
+ * Main
+ */
+
+int
+main(int argc, char* argv[])
+{
+  int arg;
+  while((arg = getopt(argc, argv, "t:r:h")) != -1)
+    switch(arg)
+    {
+    case 't':
+      minTime = strtod(optarg, NULL) / 1000.;
+      break;
+
+    case 'r':
+      runs = std::max(1, atoi(optarg));
+      break;
+
+    default:
+      fprintf(stderr, "%s usage: %s [-t ms] [-r runs] [name-prefix]\n",
+	  argv[0], argv[0]);
+      return 1;
+    }
+  if(optind < argc)
+    filter = argv[optind];
+
+  static const double nans[] = {0., .1, .5};
+  static const size_t histories[] = {1024, 65536, 1 << 20};
+  char params[256];
+
+  // input parsing (256k values, by format and number of graphs)
+  static const Trend::format_t formats[] =
+    {Trend::f_ascii, Trend::f_float, Trend::f_double, Trend::f_named};
+  static const size_t graphs[] = {1, 4, 32};
+  for(size_t f = 0; f != sizeof(formats) / sizeof(*formats); ++f)
+    for(size_t g = 0; g != sizeof(graphs) / sizeof(*graphs); ++g)
+      for(size_t n = 0; n != sizeof(nans) / sizeof(*nans); ++n)
+      {
+	genValues(1 << 18, nans[n]);
+	genInput(formats[f], graphs[g]);
+	ParseBench b(formats[f], graphs[g], 1024);
+	snprintf(params, sizeof(params), "format=%s graphs=%lu nan=%g",
+	    formatName(formats[f]), static_cast<unsigned long>(graphs[g]),
+	    nans[n]);
+	measure("parse", params, values.size(), b);
+      }
+  text.clear();
+  binary.clear();
+
+  // rings
+  genValues(1 << 20, 0.);
+  for(size_t h = 0; h != sizeof(histories) / sizeof(*histories); ++h)
+  {
+    snprintf(params, sizeof(params), "history=%lu",
+	static_cast<unsigned long>(histories[h]));
+
+    PushBench p(histories[h]);
+    measure("push", params, values.size(), p);
+
+    CopyBench c(histories[h]);
+    measure("copy", params, histories[h], c);
+  }
+
+  // graph geometry (over a full snapshot)
+  for(size_t h = 0; h != sizeof(histories) / sizeof(*histories); ++h)
+    for(size_t n = 0; n != sizeof(nans) / sizeof(*nans); ++n)
+    {
+      genValues(histories[h], nans[n]);
+      snprintf(params, sizeof(params), "history=%lu nan=%g",
+	  static_cast<unsigned long>(histories[h]), nans[n]);
+
+      RangeBench r;
+      measure("limits", params, values.size(), r);
+
+      DistribBench d(1024);
+      measure("distrib", params, values.size(), d);
+
+      LineBench l(histories[h]);
+      measure("line", params, values.size(), l);
+    }
+
+  // spectrum frames (per value)
+  static const size_t sizes[] = {256, 1024, 4096, 16384};
+  genValues(sizes[sizeof(sizes) / sizeof(*sizes) - 1], 0.);
+  for(size_t i = 0; i != sizeof(sizes) / sizeof(*sizes); ++i)
+  {
+    snprintf(params, sizeof(params), "size=%lu",
+	static_cast<unsigned long>(sizes[i]));
+    FFTBench f(sizes[i]);
+    measure("fft", params, sizes[i], f);
+  }
+
+  return 0;
+}
@@ -33,3 +33,30 @@ parseColor(GLfloat* buf, const char* color)
 
   return buf;
 }
+
+
+uint32_t
+heatColor(double v)
+{
+  // black, purple, red, orange, pale yellow (perceptually increasing)
+  static const int stops[][3] =
+  {
+    {0, 0, 4}, {87, 16, 110}, {188, 55, 84}, {249, 142, 9}, {252, 255, 164}
+  };
+  const int n = sizeof(stops) / sizeof(*stops) - 1;
+
+  // NaN is mapped to the first stop
+  double f = (v > 0.? (v < 1.? v: 1.) * n: 0.);
+  int i = static_cast<int>(f);
+  if(i == n) --i;
+  f -= i;
+
+  uint32_t texel = 0xFF000000;
+  for(int c = 0; c != 3; ++c)
+  {
+    const double x = stops[i][c] + (stops[i + 1][c] - stops[i][c]) * f;
+    texel |= static_cast<uint32_t>(x + .5) << (c * 8);
+  }
+
+  return texel;
+}
@@ -10,9 +10,16 @@
 // GL headers
 #include "gl.hh"
 
+// c system headers
+#include <stdint.h>
+
 
 // parse a color in hexadecimal format ([[#]0x]RRGGBB)
 GLfloat*
 parseColor(GLfloat* buf, const char* color);
 
+// map [0, 1] to an opaque heatmap color (0xAABBGGRR), from black to yellow
+uint32_t
+heatColor(double v);
+
 #endif
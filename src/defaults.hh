@@ -30,20 +30,26 @@ namespace Trend
   const unsigned char setCAKey = 'Z';
   const unsigned char pauseKey = ' ';
   const unsigned char latKey = 'l';
+  const unsigned char profKey = 'P';
   const unsigned char fillKey = 'f';
   const unsigned char showUndefKey = 'u';
   const unsigned char pollRateKey = 'p';
   const unsigned char changeKey = '\t';
+  const unsigned char paneKey = 'w';
   const unsigned char graphKeyKey = 'k';
   const unsigned char viewModeKey = 'K';
+  const unsigned char spectrumKey = 'F';
+  const unsigned char peakHoldKey = 'h';
   const unsigned char helpKey = '?';
 
   // Some types
   typedef double Value;
   enum input_t {absolute, incremental, differential};
-  enum format_t {f_ascii, f_float, f_double, f_short, f_int, f_long};
-  enum view_t {v_normal, v_dim, v_hide};
+  enum format_t {f_ascii, f_float, f_double, f_short, f_int, f_long, f_named};
+  enum view_t {v_normal, v_dim, v_hide, v_heatmap};
   enum mode_t {m_normal, m_editing, m_message};
+  enum command_t {c_limits = 1, c_autolim, c_zero, c_pause, c_mark, c_graph,
+    c_control};
 
   // Defaults
   const input_t input = absolute;
@@ -58,6 +64,10 @@ namespace Trend
   const bool filled = false;
   const bool showUndef = false;
   const view_t view = v_normal;
+  const bool spectrum = false;
+  const bool peakHold = false;
+  const size_t specSize = 1024;
+  const size_t specAverage = 8;
   const bool grid = false;
   const double gridres = 1.;
   const int mayor = 10;
@@ -94,16 +104,47 @@ namespace Trend
 
   // Constants
   const int maxNumLen = 128;
+  const int maxLineLen = 4096;
   const int fontHeight = 13;
   const int fontWidth = 8;
   const int strSpc = 2;
   const int intrRad = 4;
   const int intrNum = 3;
   const int distribWidth = 30;
+  const double specRange = 100.;
   const int maxGridDens = 4;
   const int latAvg = 5;
   const int persist = 2;
   const int maxPersist = 5;
+  const int maxMarks = 16;
+  const int maxCommands = 1024;
+  const int readSize = 65536;
+  const int maxEvents = 64;
+  const int maxDgrams = 128;
+  const int dgramSize = 4096;
+  const int dgramBuffer = 4 << 20;
+  const int shmPollUs = 1000;
+  const double procRate = 10.;
+  const double synthRate = 1000.;
+  const int synthTick = 1000;
+  const int synthBatch = 4096;
+  const int inflateBlocks = 8;
+  const int inflateBlockSize = 1 << 18;
+  const int chunkSize = 4 << 20;
+  const int chunkedMin = 16 << 20;
+  const int recBuffer = 1 << 20;
+  const int sinkBlocks = 16;
+  const int sinkBlockSize = 1 << 16;
+  const int metricsTimeout = 1;
+  const size_t benchFrames = 1000;
+  const int headlessWidth = 640;
+  const int headlessHeight = 480;
+  const size_t readbackDepth = 4;
+  const int videoFrames = 8;
+  const int videoRate = 30;
+  const int textRate = 20;
+  const int textCols = 80;
+  const int textRows = 24;
 
   // Help string
   const char helpStr[] =
@@ -114,6 +155,7 @@ namespace Trend
    "\n"
    "  ESC: quit/exit\n"
    "  TAB: cycle current graph\n"
+   "    w: cycle current pane\n"
    "  SPC: pause visualisation (but still continue to consume input)\n"
    "    a: toggle auto-scaling\n"
    "    A: re-scale the graph without activating auto-scaling\n"
@@ -122,7 +164,8 @@ namespace Trend
    "    S: toggle anti-aliasing\n"
    "    s: switch scrolling mode (wrap-around or scrolling)\n"
    "    v: toggle values\n"
-   "    l: show visual and maximal sync latency\n"
+   "    l: show sync latency and input counters\n"
+   "    P: show stage timings\n"
    "    L: set limits interactively\n"
    "    m: activate a marker on the current cursor position\n"
    "    f: toggle filling\n"
@@ -133,7 +176,9 @@ namespace Trend
    "    p: change polling rate interactively\n"
    "    u: toggle display of undefined values\n"
    "    k: toggle the graph key\n"
-   "    K: cycle view mode (normal, dim others or hide others)\n"
+   "    K: cycle view mode (normal, dim others, hide others or heatmap)\n"
+   "    F: toggle spectrum view\n"
+   "    h: toggle spectrum peak-hold\n"
    "\n"
    "-\ngrid-spec:\n"
    "\n"
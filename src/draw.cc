@@ -0,0 +1,229 @@
+/*
+ * draw: drawing backends
+ * Copyright(c) 2018 by wave++ "Yuri D'Elia" <wavexx@thregr.org>
+ * Distributed under GNU LGPL WITHOUT ANY WARRANTY.
+ */
+
+/*
+ * Headers
+ */
+
+// defaults
+#include "draw.hh"
+#include "font.hh"
+#include "gl.hh"
+using std::string;
+
+
+/*
+ * GLTexture
+ */
+
+namespace
+{
+  class GLTexture: public Texture
+  {
+  public:
+    int width;
+    int height;
+    GLuint name;
+
+    GLTexture(int width, int height)
+    : width(width), height(height)
+    {
+      glGenTextures(1, &name);
+      glBindTexture(GL_TEXTURE_2D, name);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+      glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA,
+	  GL_UNSIGNED_INT_8_8_8_8_REV, NULL);
+    }
+
+    ~GLTexture()
+    {
+      glDeleteTextures(1, &name);
+    }
+
+    void
+    update(int x, int n, const uint32_t* texels)
+    {
+      // only the columns are transferred, straight from the whole image
+      glBindTexture(GL_TEXTURE_2D, name);
+      glPixelStorei(GL_UNPACK_ROW_LENGTH, width);
+      glPixelStorei(GL_UNPACK_SKIP_PIXELS, x);
+      glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+      glTexSubImage2D(GL_TEXTURE_2D, 0, x, 0, n, height, GL_RGBA,
+	  GL_UNSIGNED_INT_8_8_8_8_REV, texels);
+      glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+      glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+      glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    }
+  };
+}
+
+
+/*
+ * GLDraw
+ */
+
+void
+GLDraw::init(const float* back, bool smooth)
+{
+  // Smoothing
+  if(smooth)
+  {
+    glEnable(GL_LINE_SMOOTH);
+    glHint(GL_LINE_SMOOTH_HINT, GL_FASTEST);
+  }
+  else
+    glDisable(GL_LINE_SMOOTH);
+
+  // Drawing is clipped to the viewport
+  glEnable(GL_SCISSOR_TEST);
+
+  // Blending should be enabled by default
+  glEnable(GL_BLEND);
+  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+  // Clear color
+  glClearColor(back[0], back[1], back[2], 0.0);
+
+  // Font rows are byte-aligned
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+}
+
+
+void
+GLDraw::resize(int width, int height)
+{
+  viewport(0, 0, width, height);
+}
+
+
+void
+GLDraw::viewport(int x, int y, int width, int height)
+{
+  glViewport(x, y, width, height);
+  glScissor(x, y, width, height);
+}
+
+
+void
+GLDraw::clear()
+{
+  glClear(GL_COLOR_BUFFER_BIT);
+}
+
+
+void
+GLDraw::ortho(double left, double right, double bottom, double top)
+{
+  glLoadIdentity();
+  gluOrtho2D(left, right, bottom, top);
+}
+
+
+void
+GLDraw::push()
+{
+  glPushMatrix();
+}
+
+
+void
+GLDraw::pop()
+{
+  glPopMatrix();
+}
+
+
+void
+GLDraw::color(float r, float g, float b, float a)
+{
+  glColor4f(r, g, b, a);
+}
+
+
+void
+GLDraw::begin(prim_t prim)
+{
+  static const GLenum modes[] =
+    {GL_LINES, GL_LINE_STRIP, GL_LINE_LOOP, GL_QUADS, GL_QUAD_STRIP};
+  glBegin(modes[prim]);
+}
+
+
+void
+GLDraw::vertex(double x, double y)
+{
+  glVertex2d(x, y);
+}
+
+
+void
+GLDraw::end()
+{
+  glEnd();
+}
+
+
+void
+GLDraw::text(int x, int y, const string& str)
+{
+  // the raster position is moved in window coordinates
+  glRasterPos2i(0, 0);
+  glBitmap(0, 0, 0, 0, x, y, NULL);
+
+  if(glut)
+  {
+    for(string::const_iterator p = str.begin(); p != str.end(); ++p)
+      glutBitmapCharacter(GLUT_BITMAP_8_BY_13, *p);
+    return;
+  }
+
+  for(string::const_iterator p = str.begin(); p != str.end(); ++p)
+    glBitmap(Trend::fontCellW, Trend::fontCellH, 0, Trend::fontBase,
+	Trend::fontCellW, 0, Trend::font8x13[static_cast<unsigned char>(*p)]);
+}
+
+
+Texture*
+GLDraw::texture(int width, int height)
+{
+  return new GLTexture(width, height);
+}
+
+
+void
+GLDraw::blit(Texture* tex, double s0, double s1, double x0, double y0,
+    double x1, double y1)
+{
+  GLTexture* t = static_cast<GLTexture*>(tex);
+  s0 /= t->width;
+  s1 /= t->width;
+
+  glEnable(GL_TEXTURE_2D);
+  glBindTexture(GL_TEXTURE_2D, t->name);
+  glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
+  glBegin(GL_QUADS);
+  glTexCoord2d(s0, 0.);
+  glVertex2d(x0, y0);
+  glTexCoord2d(s1, 0.);
+  glVertex2d(x1, y0);
+  glTexCoord2d(s1, 1.);
+  glVertex2d(x1, y1);
+  glTexCoord2d(s0, 1.);
+  glVertex2d(x0, y1);
+  glEnd();
+  glDisable(GL_TEXTURE_2D);
+}
+
+
+void
+GLDraw::finish(bool wait)
+{
+  if(wait) glFinish();
+  else glFlush();
+}
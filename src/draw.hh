@@ -0,0 +1,122 @@
+/*
+ * draw: drawing backends
+ * Copyright(c) 2018 by wave++ "Yuri D'Elia" <wavexx@thregr.org>
+ * Distributed under GNU LGPL WITHOUT ANY WARRANTY.
+ */
+
+#ifndef draw_hh
+#define draw_hh
+
+// system headers
+#include <string>
+
+// c system headers
+#include <stdint.h>
+
+
+/*
+ * An image of texels (0xAABBGGRR, bottom row first) owned by a backend, which
+ * is updated by columns so that only the changed ones need to be transferred.
+ */
+class Texture
+{
+public:
+  virtual ~Texture() {}
+
+  // replace columns [x, x + n) from "texels" (a whole image of the same size)
+  virtual void update(int x, int n, const uint32_t* texels) = 0;
+};
+
+
+/*
+ * The primitives used to draw a frame, following the OpenGL immediate mode:
+ * vertexes between begin() and end() are projected by the current orthographic
+ * transform (ortho() replaces it, push()/pop() save and restore it), and are
+ * blended with the current color (alpha over). Text is drawn with the built-in
+ * font at viewport coordinates (origin bottom-left, baseline at y).
+ */
+class Draw
+{
+public:
+  enum prim_t
+  {
+    p_lines,		// independent segments (pairs of vertexes)
+    p_lineStrip,	// connected segments
+    p_lineLoop,		// connected segments, closed
+    p_quads,		// independent quads (groups of four vertexes)
+    p_quadStrip		// connected quads (pairs of vertexes)
+  };
+
+  virtual ~Draw() {}
+
+  // background color and line smoothing
+  virtual void init(const float* back, bool smooth) = 0;
+
+  // size of the output in pixels (the viewport is reset to all of it)
+  virtual void resize(int width, int height) = 0;
+
+  // area of the output to draw into (origin bottom-left), drawing is clipped
+  virtual void viewport(int x, int y, int width, int height) = 0;
+
+  virtual void clear() = 0;
+  virtual void ortho(double left, double right, double bottom, double top) = 0;
+  virtual void push() = 0;
+  virtual void pop() = 0;
+
+  virtual void color(float r, float g, float b, float a = 1.f) = 0;
+
+  void
+  color(const float* rgb)
+  {
+    color(rgb[0], rgb[1], rgb[2]);
+  }
+
+  virtual void begin(prim_t prim) = 0;
+  virtual void vertex(double x, double y) = 0;
+  virtual void end() = 0;
+
+  virtual void text(int x, int y, const std::string& str) = 0;
+
+  // a texture owned by the caller, and drawing its columns [s0, s1) stretched
+  // over a rectangle (blended by the alpha of each texel)
+  virtual Texture* texture(int width, int height) = 0;
+  virtual void blit(Texture* tex, double s0, double s1, double x0, double y0,
+      double x1, double y1) = 0;
+
+  // complete the frame (waiting for the rendering to end if requested)
+  virtual void finish(bool wait) = 0;
+};
+
+
+/*
+ * Drawing on the current OpenGL context. Text uses the GLUT font when
+ * "glut" is set (for the window), the built-in copy of it otherwise (for the
+ * offscreen contexts, where GLUT is not initialized).
+ */
+class GLDraw: public Draw
+{
+  bool glut;
+
+public:
+  explicit GLDraw(bool glut = false): glut(glut) {}
+
+  void init(const float* back, bool smooth);
+  void resize(int width, int height);
+  void viewport(int x, int y, int width, int height);
+  void clear();
+  void ortho(double left, double right, double bottom, double top);
+  void push();
+  void pop();
+  void color(float r, float g, float b, float a = 1.f);
+  using Draw::color;
+  void begin(prim_t prim);
+  void vertex(double x, double y);
+  void end();
+  void text(int x, int y, const std::string& str);
+  Texture* texture(int width, int height);
+  void blit(Texture* tex, double s0, double s1, double x0, double y0,
+      double x1, double y1);
+  void finish(bool wait);
+};
+
+#endif
@@ -0,0 +1,164 @@
+/*
+ * geom: graph geometry, independent of the OpenGL output
+ * Copyright(c) 2018 by wave++ "Yuri D'Elia" <wavexx@thregr.org>
+ * Distributed under GNU LGPL WITHOUT ANY WARRANTY.
+ */
+
+#ifndef geom_hh
+#define geom_hh
+
+// defaults
+#include "defaults.hh"
+
+// system headers
+#include <algorithm>
+
+// c system headers
+#include <math.h>
+#include <stddef.h>
+
+
+// extend lo/hi to include the finite values of [begin, end)
+inline void
+valueRange(const Trend::Value* begin, const Trend::Value* end,
+    Trend::Value& lo, Trend::Value& hi)
+{
+  for(const Trend::Value* it = begin; it != end; ++it)
+  {
+    if(isfinite(*it))
+    {
+      if(!isfinite(lo) || *it < lo)
+	lo = *it;
+      if(!isfinite(hi) || *it > hi)
+	hi = *it;
+    }
+  }
+}
+
+
+// integrate the segments between consecutive values of [begin, end) over
+// "height" bins spanning [lo, hi]. Return the highest bin count
+inline double
+integrate(const Trend::Value* begin, const Trend::Value* end, double lo,
+    double hi, int height, double* bins)
+{
+  for(int y = 0; y != height; ++y)
+    bins[y] = 0.;
+
+  double max = 0;
+  const double mul = (static_cast<double>(height) / (hi - lo));
+  for(const Trend::Value* it = begin; it + 1 < end; ++it)
+  {
+    const Trend::Value* a = it;
+    const Trend::Value* b = (it + 1);
+    if(!isfinite(*a) || !isfinite(*b)) continue;
+
+    // projection
+    int first = static_cast<int>(mul * (*a - lo));
+    int last = static_cast<int>(mul * (*b - lo));
+    if(first > last) std::swap(first, last);
+
+    // fixation
+    if(last < 0 || first > height) continue;
+    if(first < 0) first = 0;
+    if(last > height) last = height;
+
+    // integration
+    for(int y = first; y != last; ++y)
+    {
+      if(++bins[y] > max)
+	max = bins[y];
+    }
+  }
+
+  return max;
+}
+
+
+// line drawing settings
+struct LineSpec
+{
+  size_t history;
+  size_t offset;
+  size_t divisions;
+  size_t pos;		// position of the last value of the snapshot
+  bool scroll;
+  bool dimmed;
+};
+
+
+/*
+ * Walk a graph snapshot producing the geometry of its line: out.shade(alpha)
+ * is called for each value, and vertexes (out.vertex(x, y)) are grouped into
+ * line strips (out.strip()) or single segments for isolated values
+ * (out.lines()), each terminated by out.end(). Return the drawing position of
+ * the last value.
+ */
+template<class Out> size_t
+walkLine(const Trend::Value* buf, const Trend::Value* end,
+    const LineSpec& spec, Out& out)
+{
+  const Trend::Value* it = buf;
+  const Trend::Value* nit = it + 1;
+  const size_t mark(spec.history + spec.offset - spec.divisions - 1);
+  bool st = false;
+  size_t pos = 0;
+
+  for(size_t i = spec.offset; it != end; ++i, ++it, ++nit)
+  {
+    if(!st && isfinite(*it) && (nit == end || isfinite(*nit)))
+    {
+      st = true;
+      out.strip();
+    }
+
+    // shade the color
+    double alpha(spec.dimmed?
+	(i > mark? 1.: .5):
+	(static_cast<float>(i - spec.offset) / spec.history));
+    out.shade(alpha);
+
+    pos = (spec.scroll? i: spec.pos - (end - it)) % spec.divisions;
+
+    if(st)
+    {
+      if(pos)
+	out.vertex(pos, *it);
+      else
+      {
+	// Cursor at the end
+	out.vertex(spec.divisions, *it);
+	out.end();
+	out.strip();
+	out.vertex(0, *it);
+      }
+    }
+    else if(isfinite(*it))
+    {
+      out.lines();
+      if(pos)
+      {
+	out.vertex(pos - 0.5, *it);
+	out.vertex(pos + 0.5, *it);
+      }
+      else
+      {
+	out.vertex(0, *it);
+	out.vertex(0.5, *it);
+	out.vertex(spec.divisions, *it);
+	out.vertex(spec.divisions - 0.5, *it);
+      }
+      out.end();
+    }
+
+    if(st && (nit == end || !isfinite(*nit)))
+    {
+      out.end();
+      st = false;
+    }
+  }
+
+  return pos;
+}
+
+#endif
@@ -0,0 +1,165 @@
+/*
+ * image: still image output - implementation
+ * Copyright(c) 2018 by wave++ "Yuri D'Elia" <wavexx@thregr.org>
+ * Distributed under GNU LGPL WITHOUT ANY WARRANTY.
+ */
+
+/*
+ * Headers
+ */
+
+// interface
+#include "image.hh"
+
+// system headers
+#include <vector>
+using std::vector;
+
+// c system headers
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+// compression libraries
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+
+/*
+ * Implementation
+ */
+
+namespace
+{
+  bool
+  hasExtension(const char* path, const char* ext)
+  {
+    size_t len = strlen(path);
+    size_t elen = strlen(ext);
+    return (len >= elen && !strcasecmp(path + len - elen, ext));
+  }
+
+
+  bool
+  writePPM(FILE* fd, int width, int height, const unsigned char* rgb)
+  {
+    const size_t stride = static_cast<size_t>(width) * 3;
+    fprintf(fd, "P6\n%d %d\n255\n", width, height);
+    for(int y = height; y--;)
+      if(fwrite(rgb + y * stride, stride, 1, fd) != 1)
+	return false;
+
+    return true;
+  }
+
+
+#ifdef HAVE_ZLIB
+  void
+  put32(unsigned char* p, uint32_t v)
+  {
+    p[0] = v >> 24;
+    p[1] = v >> 16;
+    p[2] = v >> 8;
+    p[3] = v;
+  }
+
+
+  // write a chunk with its length and checksum
+  bool
+  writeChunk(FILE* fd, const char* type, const unsigned char* data,
+      size_t len)
+  {
+    unsigned char buf[8];
+    put32(buf, len);
+    memcpy(buf + 4, type, 4);
+    uLong crc = crc32(0, buf + 4, 4);
+    if(len) crc = crc32(crc, data, len);
+
+    if(fwrite(buf, 8, 1, fd) != 1 || (len && fwrite(data, len, 1, fd) != 1))
+      return false;
+    put32(buf, crc);
+    return (fwrite(buf, 4, 1, fd) == 1);
+  }
+
+
+  bool
+  writePNG(FILE* fd, int width, int height, const unsigned char* rgb)
+  {
+    static const unsigned char magic[8] =
+      {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    if(fwrite(magic, sizeof(magic), 1, fd) != 1)
+      return false;
+
+    // 8-bit RGB, no interlacing
+    unsigned char hdr[13];
+    put32(hdr, width);
+    put32(hdr + 4, height);
+    hdr[8] = 8;
+    hdr[9] = 2;
+    hdr[10] = hdr[11] = hdr[12] = 0;
+    if(!writeChunk(fd, "IHDR", hdr, sizeof(hdr)))
+      return false;
+
+    // rows are stored top-down, each preceded by its filter type (none)
+    const size_t stride = static_cast<size_t>(width) * 3;
+    vector<unsigned char> raw((stride + 1) * height);
+    for(int y = 0; y != height; ++y)
+    {
+      unsigned char* row = &raw[(stride + 1) * y];
+      row[0] = 0;
+      memcpy(row + 1, rgb + (height - 1 - y) * stride, stride);
+    }
+
+    uLongf len = compressBound(raw.size());
+    vector<unsigned char> data(len);
+    if(compress2(&data[0], &len, &raw[0], raw.size(), Z_BEST_SPEED) != Z_OK)
+      return false;
+
+    return (writeChunk(fd, "IDAT", &data[0], len) &&
+	writeChunk(fd, "IEND", NULL, 0));
+  }
+#endif
+}
+
+
+bool
+writeImage(const char* path, int width, int height, const unsigned char* rgb)
+{
+  const bool png = hasExtension(path, ".png");
+#ifndef HAVE_ZLIB
+  if(png) return false;
+#endif
+
+  FILE* fd = fopen(path, "wb");
+  if(!fd) return false;
+
+#ifdef HAVE_ZLIB
+  bool ret = (png? writePNG(fd, width, height, rgb):
+      writePPM(fd, width, height, rgb));
+#else
+  bool ret = writePPM(fd, width, height, rgb);
+#endif
+
+  return (!fclose(fd) && ret);
+}
+
+
+void
+imageName(char* buf, size_t len, const char* pattern, unsigned long n)
+{
+  // only a single decimal conversion is accepted
+  const char* p = strchr(pattern, '%');
+  const char* q = (p? p + 1 + strspn(p + 1, "0123456789"): NULL);
+  if(!p || *q != 'd')
+  {
+    snprintf(buf, len, "%s", pattern);
+    return;
+  }
+
+  int width = atoi(p + 1);
+  snprintf(buf, len, "%.*s%0*lu%s", static_cast<int>(p - pattern), pattern,
+      width, n, q + 1);
+}
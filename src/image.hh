@@ -0,0 +1,26 @@
+/*
+ * image: still image output
+ * Copyright(c) 2018 by wave++ "Yuri D'Elia" <wavexx@thregr.org>
+ * Distributed under GNU LGPL WITHOUT ANY WARRANTY.
+ */
+
+#ifndef image_hh
+#define image_hh
+
+// c system headers
+#include <stddef.h>
+
+
+/*
+ * Write an RGB image (bottom row first, as read from OpenGL) to a file. The
+ * format is chosen by extension: PNG for ".png" (only when built with zlib),
+ * binary PPM otherwise. Return false on failure.
+ */
+bool
+writeImage(const char* path, int width, int height, const unsigned char* rgb);
+
+// format "pattern" with a sequence number ("%d" or "%0Nd", if present)
+void
+imageName(char* buf, size_t len, const char* pattern, unsigned long n);
+
+#endif
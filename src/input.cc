@@ -0,0 +1,2346 @@
+/*
+ * input: input sources and producer event loop - implementation
+ * Copyright(c) 2018 by wave++ "Yuri D'Elia" <wavexx@thregr.org>
+ * Distributed under GNU LGPL WITHOUT ANY WARRANTY.
+ */
+
+/*
+ * Headers
+ */
+
+// interface
+#include "input.hh"
+
+// system headers
+#include <algorithm>
+using std::string;
+using std::vector;
+
+// c system headers
+#include <errno.h>
+#include <math.h>
+#include <signal.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+#include <netdb.h>
+#include <sys/stat.h>
+#include <sys/epoll.h>
+#include <sys/inotify.h>
+#include <sys/timerfd.h>
+#include <sys/eventfd.h>
+#include <sys/un.h>
+
+// compression libraries
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+
+/*
+ * Helpers
+ */
+
+namespace
+{
+  // create a bound/listening inet socket on [host:]port
+  int
+  inetSocket(const string& addr, const int type)
+  {
+    string host("127.0.0.1");
+    string port(addr);
+    string::size_type p = addr.rfind(':');
+    if(p != string::npos)
+    {
+      host = addr.substr(0, p);
+      port = addr.substr(p + 1);
+      if(host.size() > 1 && host[0] == '[' && host[host.size() - 1] == ']')
+	host = host.substr(1, host.size() - 2);
+    }
+
+    addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = type;
+    hints.ai_flags = AI_PASSIVE | AI_NUMERICSERV;
+
+    addrinfo* res;
+    if(getaddrinfo((host.size()? host.c_str(): NULL), port.c_str(),
+	    &hints, &res))
+      return -1;
+
+    int fd = -1;
+    for(addrinfo* ai = res; ai; ai = ai->ai_next)
+    {
+      fd = socket(ai->ai_family, type | SOCK_NONBLOCK | SOCK_CLOEXEC,
+	  ai->ai_protocol);
+      if(fd < 0) continue;
+
+      int on = 1;
+      setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+      if(!bind(fd, ai->ai_addr, ai->ai_addrlen) &&
+	  (type != SOCK_STREAM || !listen(fd, SOMAXCONN)))
+	break;
+
+      close(fd);
+      fd = -1;
+    }
+
+    freeaddrinfo(res);
+    return fd;
+  }
+
+
+  // create a bound/listening unix socket on path
+  int
+  unixSocket(const string& path, const int type)
+  {
+    sockaddr_un sa;
+    if(path.size() >= sizeof(sa.sun_path))
+      return -1;
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sun_family = AF_UNIX;
+    memcpy(sa.sun_path, path.c_str(), path.size());
+
+    // remove stale sockets only
+    struct stat stBuf;
+    if(!lstat(path.c_str(), &stBuf) && S_ISSOCK(stBuf.st_mode))
+      unlink(path.c_str());
+
+    int fd = socket(AF_UNIX, type | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if(fd < 0) return -1;
+
+    if(bind(fd, reinterpret_cast<sockaddr*>(&sa), sizeof(sa)) ||
+	(type == SOCK_STREAM && listen(fd, SOMAXCONN)))
+    {
+      close(fd);
+      return -1;
+    }
+
+    return fd;
+  }
+
+
+  // signal an eventfd
+  void
+  post(int fd)
+  {
+    uint64_t one = 1;
+    ssize_t ret = write(fd, &one, sizeof(one));
+    (void)ret;
+  }
+
+
+  // check for a scheme prefix, returning the remainder
+  bool
+  hasScheme(const string& name, const char* scheme, string& rest)
+  {
+    size_t len = strlen(scheme);
+    if(name.compare(0, len, scheme))
+      return false;
+
+    rest = name.substr(len);
+    return true;
+  }
+}
+
+
+/*
+ * Router
+ */
+
+Router::Router(size_t base, const vector<string>& labels,
+    void (*relabel)(size_t, const string&))
+: names(labels.size()), next(0), base(base), relabel(relabel)
+{
+  for(size_t i = 0; i != labels.size(); ++i)
+  {
+    if(labels[i].empty())
+      free.push_back(i);
+    else if(names.find(labels[i].data(), labels[i].size()) == Names::npos)
+      names.insert(labels[i].data(), labels[i].size(), i);
+  }
+}
+
+
+/*
+ * Sink
+ */
+
+Sink::Sink(const string& path, size_t decimate, size_t width, Stats* stats)
+: path(path), decimate(decimate? decimate: 1),
+  blockSize(std::max(width * sizeof(double),
+	  static_cast<size_t>(Trend::sinkBlockSize))),
+  stats(stats), frames(0),
+  wake(-1), stop(false), started(false), lens(Trend::sinkBlocks),
+  full(Trend::sinkBlocks), empty(Trend::sinkBlocks), cur(Names::npos),
+  used(0)
+{}
+
+
+Sink::~Sink()
+{
+  if(started)
+  {
+    flush();
+    __atomic_store_n(&stop, true, __ATOMIC_RELEASE);
+    post(wake);
+    pthread_join(thread, NULL);
+  }
+
+  if(wake >= 0) ::close(wake);
+}
+
+
+bool
+Sink::open()
+{
+  if((wake = eventfd(0, EFD_CLOEXEC)) < 0)
+    return false;
+
+  blocks.resize(Trend::sinkBlocks * blockSize);
+  for(size_t i = 0; i != lens.size(); ++i)
+    empty.push(i);
+
+  // the output itself is opened by the writer (fifos block until a reader)
+  if(pthread_create(&thread, NULL, run, this))
+    return false;
+
+  started = true;
+  return true;
+}
+
+
+void
+Sink::flush()
+{
+  if(cur == Names::npos || !used)
+    return;
+
+  lens[cur] = used;
+  full.push(cur);
+  post(wake);
+  cur = Names::npos;
+  used = 0;
+}
+
+
+void*
+Sink::run(void* arg)
+{
+  // write errors are handled directly
+  sigset_t set;
+  sigemptyset(&set);
+  sigaddset(&set, SIGPIPE);
+  pthread_sigmask(SIG_BLOCK, &set, NULL);
+
+  static_cast<Sink*>(arg)->work();
+  return NULL;
+}
+
+
+void
+Sink::work()
+{
+  int fd = -1;
+  bool fifo = true;
+  for(;;)
+  {
+    size_t i;
+    if(!full.pop(i))
+    {
+      if(__atomic_load_n(&stop, __ATOMIC_ACQUIRE))
+	break;
+
+      uint64_t n;
+      if(::read(wake, &n, sizeof(n)) < 0 && errno != EINTR)
+	break;
+      continue;
+    }
+
+    // (re)open the output as needed (only fifos can be re-opened)
+    struct stat stBuf;
+    if(fd < 0 && fifo &&
+	(fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+	    0644)) >= 0)
+      fifo = (!fstat(fd, &stBuf) && S_ISFIFO(stBuf.st_mode));
+
+    for(size_t pos = 0; fd >= 0 && pos != lens[i];)
+    {
+      ssize_t n = ::write(fd, block(i) + pos, lens[i] - pos);
+      if(n > 0) pos += n;
+      else if(n < 0 && errno != EINTR)
+      {
+	// discard the block (fifos are re-opened for the next reader)
+	::close(fd);
+	fd = -1;
+      }
+    }
+
+    empty.push(i);
+  }
+
+  if(fd >= 0) ::close(fd);
+}
+
+
+/*
+ * Feed
+ */
+
+Feed::Feed(rr<Trend::Value>* const* rings, size_t first, size_t count,
+    Trend::input_t input, bool esc, const Hooks* hooks, Router* router)
+: data(rings + first), first(first), count(count), input(input), esc(esc),
+  hooks(hooks), router(router), sink(NULL), old(count),
+  seen(router? count: 0), col(0),
+  primed(false), frames(0), samples(0), errors(0), stamp(0), period(0),
+  left(0), escState(0), escArg(0), escNeed(0)
+{}
+
+
+bool
+Feed::escape(double v)
+{
+  // number of arguments for each command
+  static const size_t args[] = {0, 2, 1, 2, 1, 0, 1};
+
+  if(!esc)
+    return false;
+
+  switch(escState)
+  {
+  case 0:
+    // infinity starts a new sequence
+    escState = 1;
+    return true;
+
+  case 1:
+    // a double escape is a literal (undefined) value
+    escState = 0;
+    if(isinf(v))
+      return false;
+
+    if(!(v >= Trend::c_limits && v <= Trend::c_graph) || v != floor(v))
+      return true;
+
+    cmd.code = static_cast<Trend::command_t>(v);
+    escArg = 0;
+    escNeed = args[cmd.code];
+    if(escNeed) escState = 2;
+    else dispatch();
+    return true;
+
+  default:
+    cmd.args[escArg++] = v;
+    if(escArg == escNeed)
+    {
+      escState = 0;
+      dispatch();
+    }
+    return true;
+  }
+}
+
+
+void
+Feed::dispatch()
+{
+  cmd.graph = first;
+  cmd.pos = data[0]->position();
+
+  switch(cmd.code)
+  {
+  case Trend::c_limits:
+    // as for the remote command, limits must be finite and increasing
+    if(!(isfinite(cmd.args[0]) && isfinite(cmd.args[1])
+	    && cmd.args[0] < cmd.args[1]))
+      return;
+    break;
+
+  case Trend::c_zero:
+  case Trend::c_graph:
+    // graphs are numbered from 1 within the source
+    if(!(cmd.args[0] >= 1 && cmd.args[0] <= count))
+      return;
+    cmd.graph = first + static_cast<size_t>(cmd.args[0]) - 1;
+    cmd.args[0] = cmd.args[1];
+    break;
+
+  default:;
+  }
+
+  hooks->command(cmd);
+}
+
+
+/*
+ * Recorder
+ */
+
+Recorder::~Recorder()
+{
+  if(file)
+    fclose(file);
+}
+
+
+bool
+Recorder::open(const char* path)
+{
+  if(!(file = fopen(path, "wb")))
+    return false;
+
+  setvbuf(file, NULL, _IOFBF, Trend::recBuffer);
+  start = monotonic();
+  return (fwrite(recMagic, sizeof(recMagic), 1, file) == 1);
+}
+
+
+void
+Recorder::write(unsigned input, unsigned channel, int flags, const char* p,
+    size_t len)
+{
+  RecordHeader h;
+  h.time = monotonic() - start;
+  h.len = len;
+  h.input = input;
+  h.flags = flags;
+  h.channel = channel;
+
+  fwrite(&h, sizeof(h), 1, file);
+  if(len) fwrite(p, len, 1, file);
+}
+
+
+/*
+ * Source
+ */
+
+Source::~Source()
+{}
+
+
+/*
+ * Stream
+ */
+
+Stream::Stream(const string& name, Trend::format_t format, const Feed& feed)
+: Source(name), parser(format), feed(feed), reopen(false),
+  buf(Trend::readSize)
+{}
+
+
+Stream::Stream(const string& name, int fd, Trend::format_t format,
+    const Feed& feed)
+: Source(name), parser(format), feed(feed), reopen(false),
+  buf(Trend::readSize)
+{
+  this->fd = fd;
+}
+
+
+Stream::~Stream()
+{
+  if(fd > STDIN_FILENO)
+    ::close(fd);
+}
+
+
+bool
+Stream::openFd()
+{
+  if(name == "-")
+    fd = STDIN_FILENO;
+  else if((fd = ::open(name.c_str(), O_RDONLY | O_NONBLOCK)) < 0)
+    return false;
+
+  // check for useless file types
+  struct stat stBuf;
+  if(fstat(fd, &stBuf) || S_ISDIR(stBuf.st_mode))
+  {
+    closeFd();
+    return false;
+  }
+
+  // fifos are re-opened on EOF (but not stdin)
+  reopen = (name != "-" &&
+      !S_ISREG(stBuf.st_mode) && !S_ISBLK(stBuf.st_mode));
+
+  loop->watch(this);
+  return true;
+}
+
+
+void
+Stream::closeFd()
+{
+  loop->unwatch(this);
+  if(fd != STDIN_FILENO)
+    ::close(fd);
+  fd = -1;
+}
+
+
+bool
+Stream::open(Loop& loop)
+{
+  this->loop = &loop;
+  if(fd < 0)
+    return openFd();
+
+  // already connected
+  loop.watch(this);
+  return true;
+}
+
+
+bool
+Stream::ready()
+{
+  ssize_t n = ::read(fd, &buf[0], buf.size());
+  if(n > 0)
+  {
+    record(&buf[0], n);
+    feed.parse(parser, &buf[0], &buf[0] + n);
+    feed.commit();
+    return true;
+  }
+  if(n < 0 && (errno == EAGAIN || errno == EINTR))
+    return true;
+
+  // EOF: terminate for regular files, start over for fifos
+  record(NULL, 0, Recorder::r_end);
+  if(!reopen)
+    return false;
+
+  closeFd();
+  parser.reset();
+  feed.reset();
+  return openFd();
+}
+
+
+/*
+ * Inflate
+ */
+
+Inflate::Inflate(const string& name, codec_t codec, Trend::format_t format,
+    const Feed& feed)
+: Source(name), parser(format), feed(feed), codec(codec), file(-1), wake(-1),
+  stop(false), done(false), started(false), lens(Trend::inflateBlocks),
+  full(Trend::inflateBlocks), empty(Trend::inflateBlocks)
+{}
+
+
+Inflate::~Inflate()
+{
+  if(started)
+  {
+    __atomic_store_n(&stop, true, __ATOMIC_RELEASE);
+    post(wake);
+    pthread_join(thread, NULL);
+  }
+
+  if(file >= 0) ::close(file);
+  if(wake >= 0) ::close(wake);
+  if(fd >= 0) ::close(fd);
+}
+
+
+bool
+Inflate::detect(const string& name, codec_t& codec)
+{
+  int tmp = ::open(name.c_str(), O_RDONLY | O_CLOEXEC);
+  if(tmp < 0) return false;
+
+  // only regular files can be peeked at
+  struct stat stBuf;
+  unsigned char magic[4] = {0, 0, 0, 0};
+  bool reg = (!fstat(tmp, &stBuf) && S_ISREG(stBuf.st_mode) &&
+      pread(tmp, magic, sizeof(magic), 0) == sizeof(magic));
+  ::close(tmp);
+  if(!reg) return false;
+
+#ifdef HAVE_ZLIB
+  if(magic[0] == 0x1f && magic[1] == 0x8b)
+  {
+    codec = gzip;
+    return true;
+  }
+#endif
+#ifdef HAVE_ZSTD
+  if(magic[0] == 0x28 && magic[1] == 0xb5 && magic[2] == 0x2f &&
+      magic[3] == 0xfd)
+  {
+    codec = zstd;
+    return true;
+  }
+#endif
+
+  return false;
+}
+
+
+bool
+Inflate::open(Loop& loop)
+{
+  this->loop = &loop;
+
+  if((file = ::open(name.c_str(), O_RDONLY | O_CLOEXEC)) < 0 ||
+      (fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) < 0 ||
+      (wake = eventfd(0, EFD_CLOEXEC)) < 0)
+    return false;
+
+  // all the blocks are initially free
+  blocks.resize(static_cast<size_t>(Trend::inflateBlocks) *
+      Trend::inflateBlockSize);
+  for(size_t i = 0; i != lens.size(); ++i)
+    empty.push(i);
+
+  if(pthread_create(&thread, NULL, run, this))
+    return false;
+  started = true;
+
+  loop.watch(this);
+  return true;
+}
+
+
+bool
+Inflate::ready()
+{
+  uint64_t n;
+  if(::read(fd, &n, sizeof(n)) < 0 && errno != EAGAIN)
+    return false;
+
+  // blocks given before completion are visible once done is
+  bool end = __atomic_load_n(&done, __ATOMIC_ACQUIRE);
+
+  size_t i;
+  bool freed = false;
+  while(full.pop(i))
+  {
+    record(block(i), lens[i]);
+    feed.parse(parser, block(i), block(i) + lens[i]);
+    empty.push(i);
+    freed = true;
+  }
+  feed.commit();
+
+  if(freed) post(wake);
+
+  return !end;
+}
+
+
+char*
+Inflate::block(size_t i)
+{
+  return &blocks[i * Trend::inflateBlockSize];
+}
+
+
+// wait for a free block (thread side), npos when stopped
+size_t
+Inflate::take()
+{
+  size_t i;
+  while(!empty.pop(i))
+  {
+    if(__atomic_load_n(&stop, __ATOMIC_ACQUIRE))
+      return Names::npos;
+
+    uint64_t n;
+    if(::read(wake, &n, sizeof(n)) < 0 && errno != EINTR)
+      return Names::npos;
+  }
+
+  return i;
+}
+
+
+// pass a filled block to the loop (thread side)
+void
+Inflate::give(size_t i, size_t len)
+{
+  lens[i] = len;
+  full.push(i);
+  post(fd);
+}
+
+
+void*
+Inflate::run(void* arg)
+{
+  Inflate* self = static_cast<Inflate*>(arg);
+
+  switch(self->codec)
+  {
+  case gzip: self->inflateGzip(); break;
+  case zstd: self->inflateZstd(); break;
+  }
+
+  // signal completion (also on errors)
+  __atomic_store_n(&self->done, true, __ATOMIC_RELEASE);
+  post(self->fd);
+  return NULL;
+}
+
+
+void
+Inflate::inflateGzip()
+{
+#ifdef HAVE_ZLIB
+  const size_t size = Trend::inflateBlockSize;
+  vector<char> in(Trend::readSize);
+
+  // gzip/zlib headers are detected automatically
+  z_stream z;
+  memset(&z, 0, sizeof(z));
+  if(inflateInit2(&z, 15 + 32) != Z_OK)
+    return;
+
+  size_t i = take();
+  if(i == Names::npos)
+  {
+    inflateEnd(&z);
+    return;
+  }
+  z.next_out = reinterpret_cast<Bytef*>(block(i));
+  z.avail_out = size;
+
+  bool eof = false;
+  for(;;)
+  {
+    if(!eof && !z.avail_in)
+    {
+      ssize_t n = ::read(file, &in[0], in.size());
+      if(n < 0 && errno == EINTR) continue;
+      if(n <= 0) eof = true;
+      else
+      {
+	z.next_in = reinterpret_cast<Bytef*>(&in[0]);
+	z.avail_in = n;
+      }
+    }
+
+    int ret = ::inflate(&z, Z_NO_FLUSH);
+    if(ret == Z_STREAM_END)
+    {
+      // concatenated members
+      if(inflateReset(&z) != Z_OK) break;
+    }
+    else if(ret != Z_OK && ret != Z_BUF_ERROR)
+      break;
+
+    if(!z.avail_out)
+    {
+      give(i, size);
+      if((i = take()) == Names::npos)
+      {
+	inflateEnd(&z);
+	return;
+      }
+      z.next_out = reinterpret_cast<Bytef*>(block(i));
+      z.avail_out = size;
+    }
+    else if(eof)
+      break;
+  }
+
+  give(i, size - z.avail_out);
+  inflateEnd(&z);
+#endif
+}
+
+
+void
+Inflate::inflateZstd()
+{
+#ifdef HAVE_ZSTD
+  const size_t size = Trend::inflateBlockSize;
+  vector<char> in(ZSTD_DStreamInSize());
+
+  ZSTD_DStream* zs = ZSTD_createDStream();
+  if(!zs) return;
+  ZSTD_initDStream(zs);
+
+  size_t i = take();
+  if(i == Names::npos)
+  {
+    ZSTD_freeDStream(zs);
+    return;
+  }
+
+  ZSTD_inBuffer zin = {&in[0], 0, 0};
+  ZSTD_outBuffer zout = {block(i), size, 0};
+
+  // concatenated frames are handled transparently
+  bool eof = false;
+  for(;;)
+  {
+    if(!eof && zin.pos == zin.size)
+    {
+      ssize_t n = ::read(file, &in[0], in.size());
+      if(n < 0 && errno == EINTR) continue;
+      if(n <= 0) eof = true;
+      else
+      {
+	zin.size = n;
+	zin.pos = 0;
+      }
+    }
+
+    if(ZSTD_isError(ZSTD_decompressStream(zs, &zout, &zin)))
+      break;
+
+    if(zout.pos == zout.size)
+    {
+      give(i, size);
+      if((i = take()) == Names::npos)
+      {
+	ZSTD_freeDStream(zs);
+	return;
+      }
+      zout.dst = block(i);
+      zout.pos = 0;
+    }
+    else if(eof)
+      break;
+  }
+
+  give(i, zout.pos);
+  ZSTD_freeDStream(zs);
+#endif
+}
+
+
+/*
+ * Chunked
+ */
+
+namespace
+{
+  // values converted from a chunk
+  struct Values
+  {
+    vector<double>& values;
+    size_t& errors;
+
+    void
+    value(double v)
+    {
+      values.push_back(v);
+    }
+
+    void
+    named(const char*, size_t, double)
+    {}
+
+    void
+    error()
+    {
+      ++errors;
+    }
+  };
+}
+
+
+Chunked::Chunked(const string& name, const Feed& feed)
+: Source(name), feed(feed), map(NULL), len(0), next(0), cur(0), stop(false)
+{
+  pthread_mutex_init(&mutex, NULL);
+  pthread_cond_init(&cond, NULL);
+}
+
+
+Chunked::~Chunked()
+{
+  pthread_mutex_lock(&mutex);
+  stop = true;
+  pthread_cond_broadcast(&cond);
+  pthread_mutex_unlock(&mutex);
+
+  for(vector<pthread_t>::iterator it = workers.begin();
+      it != workers.end(); ++it)
+    pthread_join(*it, NULL);
+
+  if(map) munmap(const_cast<char*>(map), len);
+  if(fd >= 0) ::close(fd);
+  pthread_cond_destroy(&cond);
+  pthread_mutex_destroy(&mutex);
+}
+
+
+bool
+Chunked::detect(const string& name)
+{
+  struct stat stBuf;
+  return (sysconf(_SC_NPROCESSORS_ONLN) > 1 &&
+      !stat(name.c_str(), &stBuf) && S_ISREG(stBuf.st_mode) &&
+      stBuf.st_size >= Trend::chunkedMin);
+}
+
+
+bool
+Chunked::open(Loop& loop)
+{
+  this->loop = &loop;
+
+  // map the whole file
+  int file = ::open(name.c_str(), O_RDONLY | O_CLOEXEC);
+  if(file < 0) return false;
+
+  struct stat stBuf;
+  void* ptr = MAP_FAILED;
+  if(!fstat(file, &stBuf) && stBuf.st_size > 0)
+  {
+    len = stBuf.st_size;
+    ptr = mmap(NULL, len, PROT_READ, MAP_PRIVATE, file, 0);
+  }
+  ::close(file);
+  if(ptr == MAP_FAILED) return false;
+  map = static_cast<const char*>(ptr);
+
+  // split at the first line boundary following each chunk
+  bounds.push_back(0);
+  for(size_t p = Trend::chunkSize; p < len; p += Trend::chunkSize)
+  {
+    const char* nl = static_cast<const char*>(memchr(map + p, '\n', len - p));
+    if(!nl) break;
+    p = nl + 1 - map;
+    bounds.push_back(p);
+  }
+  if(bounds.back() != len)
+    bounds.push_back(len);
+
+  if((fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) < 0)
+    return false;
+
+  // two chunks in flight for each worker
+  long n = sysconf(_SC_NPROCESSORS_ONLN);
+  slots.resize(2 * (n > 1? n: 1));
+  for(vector<Chunk>::iterator it = slots.begin(); it != slots.end(); ++it)
+  {
+    it->ready = false;
+    it->errors = 0;
+  }
+
+  for(long i = 0; i < n; ++i)
+  {
+    pthread_t thread;
+    if(pthread_create(&thread, NULL, run, this)) break;
+    workers.push_back(thread);
+  }
+  if(!workers.size())
+    return false;
+
+  loop.watch(this);
+  return true;
+}
+
+
+void*
+Chunked::run(void* arg)
+{
+  static_cast<Chunked*>(arg)->work();
+  return NULL;
+}
+
+
+void
+Chunked::work()
+{
+  const size_t count = bounds.size() - 1;
+  Parser parser(Trend::f_ascii);
+
+  pthread_mutex_lock(&mutex);
+  for(;;)
+  {
+    // wait for a free slot
+    while(!stop && next != count && next - cur == slots.size())
+      pthread_cond_wait(&cond, &mutex);
+    if(stop || next == count)
+      break;
+
+    size_t i = next++;
+    pthread_mutex_unlock(&mutex);
+
+    // chunks start and end at value boundaries
+    Chunk& c = slots[i % slots.size()];
+    Values out = {c.values, c.errors};
+    parser.reset();
+    parser.feed(map + bounds[i], map + bounds[i + 1], out);
+
+    pthread_mutex_lock(&mutex);
+    c.ready = true;
+    post(fd);
+  }
+  pthread_mutex_unlock(&mutex);
+}
+
+
+bool
+Chunked::ready()
+{
+  uint64_t n;
+  if(::read(fd, &n, sizeof(n)) < 0 && errno != EAGAIN)
+    return false;
+
+  // merge completed chunks in order
+  const size_t count = bounds.size() - 1;
+  pthread_mutex_lock(&mutex);
+  while(cur != count && slots[cur % slots.size()].ready)
+  {
+    Chunk& c = slots[cur % slots.size()];
+    pthread_mutex_unlock(&mutex);
+
+    record(map + bounds[cur], bounds[cur + 1] - bounds[cur]);
+    for(vector<double>::const_iterator it = c.values.begin();
+	it != c.values.end(); ++it)
+      feed.value(*it);
+    c.values.clear();
+    feed.error(c.errors);
+    c.errors = 0;
+    feed.commit();
+
+    pthread_mutex_lock(&mutex);
+    c.ready = false;
+    ++cur;
+    pthread_cond_broadcast(&cond);
+  }
+
+  bool end = (cur == count);
+  pthread_mutex_unlock(&mutex);
+  return !end;
+}
+
+
+/*
+ * Listener
+ */
+
+Listener::Listener(const string& name, Trend::format_t format,
+    const Feed& feed)
+: Source(name), format(format), feed(feed)
+{}
+
+
+Listener::~Listener()
+{
+  if(fd >= 0)
+    ::close(fd);
+  if(path.size())
+    unlink(path.c_str());
+}
+
+
+bool
+Listener::open(Loop& loop)
+{
+  this->loop = &loop;
+
+  string addr;
+  if(hasScheme(name, "unix:", addr))
+  {
+    if((fd = unixSocket(addr, SOCK_STREAM)) >= 0)
+      path = addr;
+  }
+  else if(hasScheme(name, "tcp:", addr))
+    fd = inetSocket(addr, SOCK_STREAM);
+
+  if(fd < 0)
+    return false;
+
+  loop.watch(this);
+  return true;
+}
+
+
+bool
+Listener::ready()
+{
+  for(int i = 0; i != Trend::maxEvents; ++i)
+  {
+    int cfd = accept4(fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if(cfd < 0)
+      return (errno != EBADF && errno != EINVAL);
+
+    Stream* stream = new Stream(name, cfd, format, feed);
+    stream->tap(rec, input);
+    loop->add(stream);
+  }
+
+  return true;
+}
+
+
+/*
+ * Datagram
+ */
+
+Datagram::Datagram(const string& name, Trend::format_t format,
+    const Feed& feed)
+: Source(name), parser(format), feed(feed),
+  buf(Trend::maxDgrams * Trend::dgramSize),
+  iov(Trend::maxDgrams), msgs(Trend::maxDgrams)
+{
+  memset(&msgs[0], 0, sizeof(mmsghdr) * msgs.size());
+  for(size_t i = 0; i != msgs.size(); ++i)
+  {
+    iov[i].iov_base = &buf[i * Trend::dgramSize];
+    iov[i].iov_len = Trend::dgramSize;
+    msgs[i].msg_hdr.msg_iov = &iov[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+  }
+}
+
+
+Datagram::~Datagram()
+{
+  if(fd >= 0)
+    ::close(fd);
+}
+
+
+bool
+Datagram::open(Loop& loop)
+{
+  this->loop = &loop;
+
+  string addr;
+  if(!hasScheme(name, "udp:", addr) ||
+      (fd = inetSocket(addr, SOCK_DGRAM)) < 0)
+    return false;
+
+  // absorb bursts while the loop is busy elsewhere
+  int size = Trend::dgramBuffer;
+  setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+
+  loop.watch(this);
+  return true;
+}
+
+
+bool
+Datagram::ready()
+{
+  int n = recvmmsg(fd, &msgs[0], msgs.size(), MSG_DONTWAIT, NULL);
+  if(n < 0)
+    return (errno != EBADF && errno != EINVAL);
+
+  // each datagram starts a new frame
+  for(int i = 0; i != n; ++i)
+  {
+    const char* p = static_cast<const char*>(iov[i].iov_base);
+    record(p, msgs[i].msg_len, Recorder::r_datagram);
+    feed.parse(parser, p, p + msgs[i].msg_len);
+    parser.flush(feed);
+    feed.align();
+  }
+
+  feed.commit();
+  return true;
+}
+
+
+/*
+ * Follow
+ */
+
+Follow::Follow(const string& name, Trend::format_t format, const Feed& feed)
+: Source(name), parser(format), feed(feed), buf(Trend::readSize),
+  file(-1), wd(-1), dev(0), ino(0), offset(0)
+{
+  hasScheme(name, "follow:", path);
+}
+
+
+Follow::~Follow()
+{
+  if(file >= 0)
+    ::close(file);
+  if(fd >= 0)
+    ::close(fd);
+}
+
+
+bool
+Follow::openFile()
+{
+  if((file = ::open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC)) < 0)
+    return false;
+
+  struct stat stBuf;
+  if(fstat(file, &stBuf) || !S_ISREG(stBuf.st_mode))
+  {
+    ::close(file);
+    file = -1;
+    return false;
+  }
+
+  dev = stBuf.st_dev;
+  ino = stBuf.st_ino;
+  offset = 0;
+  wd = inotify_add_watch(fd, path.c_str(), IN_MODIFY | IN_ATTRIB |
+      IN_MOVE_SELF | IN_DELETE_SELF);
+  return true;
+}
+
+
+void
+Follow::closeFile()
+{
+  // the watch is already gone if the file was deleted
+  inotify_rm_watch(fd, wd);
+  ::close(file);
+  file = -1;
+}
+
+
+bool
+Follow::open(Loop& loop)
+{
+  this->loop = &loop;
+
+  // watch the directory for re-creation of the file
+  string::size_type p = path.rfind('/');
+  string dir(p == string::npos? ".": (p? path.substr(0, p): "/"));
+
+  if((fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC)) < 0 ||
+      inotify_add_watch(fd, dir.c_str(), IN_CREATE | IN_MOVED_TO) < 0)
+    return false;
+
+  // a missing file is waited for
+  if(!openFile() && errno != ENOENT)
+    return false;
+
+  loop.watch(this);
+  loop.pending(this, file >= 0);
+  return true;
+}
+
+
+// check for truncation/rotation at EOF, return true when there's new data
+bool
+Follow::check()
+{
+  struct stat stBuf;
+
+  if(file >= 0)
+  {
+    if(!fstat(file, &stBuf) && stBuf.st_size < offset)
+    {
+      // truncated: start over
+      lseek(file, 0, SEEK_SET);
+      offset = 0;
+      parser.reset();
+      feed.align();
+      record(NULL, 0, Recorder::r_align);
+      return true;
+    }
+
+    // still the same file, or waiting for the replacement
+    if(stat(path.c_str(), &stBuf) ||
+	(stBuf.st_dev == dev && stBuf.st_ino == ino))
+      return false;
+
+    // rotated: the old file is consumed
+    closeFile();
+  }
+
+  if(!openFile())
+    return false;
+
+  parser.reset();
+  feed.align();
+  record(NULL, 0, Recorder::r_align);
+  return true;
+}
+
+
+bool
+Follow::ready()
+{
+  // only the current state matters, not the events themselves
+  char ev[16 * (sizeof(inotify_event) + NAME_MAX + 1)];
+  while(::read(fd, ev, sizeof(ev)) > 0);
+
+  if(file >= 0)
+  {
+    ssize_t n = ::read(file, &buf[0], buf.size());
+    if(n > 0)
+    {
+      offset += n;
+      record(&buf[0], n);
+      feed.parse(parser, &buf[0], &buf[0] + n);
+      feed.commit();
+      loop->pending(this, true);
+      return true;
+    }
+    if(n < 0 && errno == EINTR)
+      return true;
+  }
+
+  // EOF: wait for further notifications unless something changed
+  loop->pending(this, check());
+  return true;
+}
+
+
+/*
+ * Shm
+ */
+
+Shm::Shm(const string& name, const Feed& feed)
+: Source(name), feed(feed), obj(-1), shm(NULL), len(0), columns(0), size(0),
+  cur(0)
+{}
+
+
+Shm::~Shm()
+{
+  if(shm)
+    munmap(const_cast<trend_shm*>(shm), len);
+  if(obj >= 0)
+    ::close(obj);
+  if(fd >= 0)
+    ::close(fd);
+}
+
+
+// (re)map the whole object and validate its layout, false if not ready
+bool
+Shm::map()
+{
+  if(shm)
+  {
+    munmap(const_cast<trend_shm*>(shm), len);
+    shm = NULL;
+  }
+
+  struct stat stBuf;
+  if(fstat(obj, &stBuf) ||
+      static_cast<size_t>(stBuf.st_size) < sizeof(trend_shm))
+    return false;
+  len = stBuf.st_size;
+  void* addr = mmap(NULL, len, PROT_READ, MAP_SHARED, obj, 0);
+  if(addr == MAP_FAILED) return false;
+
+  // the layout is read once: the ring needs at least two frames, one of
+  // them being possibly overwritten at any time
+  shm = static_cast<const trend_shm*>(addr);
+  const uint32_t c = shm->columns;
+  const uint32_t s = shm->size;
+  if(__atomic_load_n(&shm->magic, __ATOMIC_ACQUIRE) != TREND_SHM_MAGIC ||
+      shm->version != TREND_SHM_VERSION || !c || s < 2 ||
+      len < trend_shm_length(c, s))
+  {
+    munmap(addr, len);
+    shm = NULL;
+    return false;
+  }
+  columns = c;
+  size = s;
+  buf.resize(static_cast<size_t>(columns) * size);
+
+  // start with the current (intact) contents of the ring
+  uint64_t pos = __atomic_load_n(&shm->pos, __ATOMIC_ACQUIRE);
+  cur = (pos >= size? pos - size + 1: 0);
+  return true;
+}
+
+
+bool
+Shm::open(Loop& loop)
+{
+  this->loop = &loop;
+
+  string path;
+  hasScheme(name, "shm:", path);
+  if(path.empty() || path[0] != '/')
+    path = "/" + path;
+
+  // the object is kept open to detect and follow restarts of the writer
+  if((obj = shm_open(path.c_str(), O_RDONLY | O_CLOEXEC, 0)) < 0 || !map())
+    return false;
+
+  // the ring is polled at each tick
+  itimerspec ts;
+  ts.it_interval.tv_sec = 0;
+  ts.it_interval.tv_nsec = Trend::shmPollUs * 1000;
+  ts.it_value = ts.it_interval;
+
+  if((fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)) < 0 ||
+      timerfd_settime(fd, 0, &ts, NULL))
+    return false;
+
+  loop.watch(this);
+  return true;
+}
+
+
+bool
+Shm::ready()
+{
+  uint64_t ticks;
+  if(::read(fd, &ticks, sizeof(ticks)) < 0 && errno != EAGAIN)
+    return false;
+
+  // a restarting writer truncates the object and may change its layout:
+  // check the length before touching the mapping, and map it again (waiting
+  // for the new header) when anything changed
+  struct stat stBuf;
+  if(fstat(obj, &stBuf))
+    return false;
+  if(!shm || static_cast<size_t>(stBuf.st_size) != len ||
+      __atomic_load_n(&shm->magic, __ATOMIC_ACQUIRE) != TREND_SHM_MAGIC ||
+      shm->columns != columns || shm->size != size)
+  {
+    if(!map()) return true;
+    feed.align();
+  }
+
+  const double* data = trend_shm_data(shm);
+  uint64_t pos = __atomic_load_n(&shm->pos, __ATOMIC_ACQUIRE);
+  if(pos == cur) return true;
+  if(pos < cur)
+  {
+    // the writer restarted
+    cur = (pos >= size? pos - size + 1: 0);
+    feed.align();
+  }
+  if(pos - cur >= size)
+    cur = pos - size + 1;
+
+  // copy the frames (at most two chunks) and validate them afterward
+  uint64_t n = pos - cur;
+  uint64_t b = cur % size;
+  uint64_t c = std::min(n, size - b);
+  memcpy(&buf[0], data + b * columns, sizeof(double) * columns * c);
+  memcpy(&buf[c * columns], data, sizeof(double) * columns * (n - c));
+
+  // as in a seqlock, the fence keeps the copy before the second load. The
+  // writer may be storing frame "end" over frame "end - size" meanwhile: the
+  // older frames are dropped, and the whole batch when the writer restarted
+  // or lapped it (resynchronizing on the next round)
+  __atomic_thread_fence(__ATOMIC_ACQUIRE);
+  uint64_t end = __atomic_load_n(&shm->pos, __ATOMIC_RELAXED);
+  if(end < cur)
+    return true;
+  uint64_t first = (end - cur >= size? end - cur - size + 1: 0);
+  if(first >= n)
+    return true;
+
+  // map the columns to the graphs
+  const size_t count = feed.size();
+  for(const double* it = &buf[first * columns]; it < &buf[n * columns];
+      it += columns)
+  {
+    for(size_t i = 0; i != count; ++i)
+      feed.value(i < columns? it[i]: NAN);
+  }
+
+  cur = pos;
+  feed.commit();
+  return true;
+}
+
+
+/*
+ * Proc
+ */
+
+namespace
+{
+  struct ProcFile
+  {
+    const char* name;
+    const char* path;
+    Proc::kind_t kind;
+    size_t width;
+    const char* keys;
+  };
+
+  // supported files, raw values for each key and default keys
+  const ProcFile procFiles[] =
+  {
+    {"meminfo", "/proc/meminfo", Proc::p_meminfo, 1, "Active"},
+    {"vmstat", "/proc/vmstat", Proc::p_vmstat, 1, "pgfault"},
+    {"net", "/proc/net/dev", Proc::p_net, 2, "eth0"},
+    {"stat", "/proc/stat", Proc::p_stat, 2, "cpu"},
+    {"loadavg", "/proc/loadavg", Proc::p_loadavg, 3, ""},
+  };
+}
+
+
+Proc::Proc(const string& name, const Feed& feed)
+: Source(name), feed(feed), kind(p_meminfo), path(NULL), width(0), file(-1),
+  rate(Trend::procRate), primed(false)
+{
+  string spec;
+  hasScheme(name, "proc:", spec);
+
+  // optional rate
+  string::size_type p = spec.rfind('@');
+  if(p != string::npos)
+  {
+    rate = strtod(spec.c_str() + p + 1, NULL);
+    spec.erase(p);
+  }
+
+  // file and optional keys
+  string list;
+  p = spec.find(':');
+  if(p != string::npos)
+  {
+    list = spec.substr(p + 1);
+    spec.erase(p);
+  }
+
+  const size_t nFiles = sizeof(procFiles) / sizeof(*procFiles);
+  for(size_t i = 0; i != nFiles; ++i)
+  {
+    if(spec != procFiles[i].name)
+      continue;
+
+    kind = procFiles[i].kind;
+    path = procFiles[i].path;
+    width = procFiles[i].width;
+    if(list.empty()) list = procFiles[i].keys;
+    break;
+  }
+
+  for(string::size_type b = 0;; b = p + 1)
+  {
+    p = list.find(',', b);
+    keys.push_back(list.substr(b, p - b));
+    if(p == string::npos) break;
+  }
+}
+
+
+Proc::~Proc()
+{
+  if(file >= 0)
+    ::close(file);
+  if(fd >= 0)
+    ::close(fd);
+}
+
+
+bool
+Proc::open(Loop& loop)
+{
+  this->loop = &loop;
+  if(!path || !(rate > 0))
+    return false;
+
+  if((file = ::open(path, O_RDONLY | O_CLOEXEC)) < 0)
+    return false;
+
+  // all the buffers are sized once
+  buf.resize(Trend::readSize);
+  raw.resize(keys.size() * width);
+  old.resize(raw.size());
+  out.resize(kind == p_stat? keys.size(): raw.size());
+
+  // sampling is driven by the timer only
+  itimerspec ts;
+  long ns = static_cast<long>(1e9 / rate);
+  ts.it_interval.tv_sec = ns / 1000000000;
+  ts.it_interval.tv_nsec = ns % 1000000000;
+  ts.it_value = ts.it_interval;
+  if(!ns) ts.it_value.tv_nsec = ts.it_interval.tv_nsec = 1;
+
+  if((fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)) < 0 ||
+      timerfd_settime(fd, 0, &ts, NULL))
+    return false;
+
+  loop.watch(this);
+  return true;
+}
+
+
+size_t
+Proc::find(const char* s, size_t len) const
+{
+  for(size_t i = 0; i != keys.size(); ++i)
+    if(keys[i].size() == len && !memcmp(keys[i].data(), s, len))
+      return i;
+
+  return Names::npos;
+}
+
+
+bool
+Proc::sample()
+{
+  // re-read the whole file from the start
+  size_t n = 0;
+  ssize_t r = 0;
+  while(n != buf.size() - 1 &&
+      (r = pread(file, &buf[n], buf.size() - 1 - n, n)) > 0)
+    n += r;
+  if(r < 0)
+    return false;
+
+  char* const last = &buf[0] + n;
+  *last = 0;
+  std::fill(raw.begin(), raw.end(), NAN);
+
+  for(char* p = &buf[0]; p != last;)
+  {
+    char* end = static_cast<char*>(memchr(p, '\n', last - p));
+    if(end) *end = 0;
+    else end = last;
+
+    // key (followed by ':' or blanks) and numeric fields
+    while(*p == ' ') ++p;
+    char* q = p;
+    while(*q && *q != ':' && *q != ' ') ++q;
+    size_t k = (kind == p_loadavg? 0: find(p, q - p));
+    if(kind == p_loadavg) q = p;
+    else if(*q == ':') ++q;
+
+    if(k != Names::npos)
+    {
+      double f[16];
+      size_t nf = 0;
+      for(char* t; nf != 16; ++nf, q = t)
+      {
+	f[nf] = strtod(q, &t);
+	if(t == q) break;
+      }
+
+      double* v = &raw[k * width];
+      switch(kind)
+      {
+      case p_meminfo:
+      case p_vmstat:
+	if(nf) v[0] = f[0];
+	break;
+
+      case p_net:
+	// receive and transmit bytes
+	if(nf > 8)
+	{
+	  v[0] = f[0];
+	  v[1] = f[8];
+	}
+	break;
+
+      case p_stat:
+	// busy and total time for cpu lines, first field otherwise
+	if(nf >= 8 && !keys[k].compare(0, 3, "cpu"))
+	{
+	  double total = 0.;
+	  for(size_t i = 0; i != 8; ++i) total += f[i];
+	  v[0] = total - f[3] - f[4];
+	  v[1] = total;
+	}
+	else if(nf)
+	  v[0] = f[0];
+	break;
+
+      case p_loadavg:
+	for(size_t i = 0; i != nf && i != width; ++i)
+	  v[i] = f[i];
+	break;
+      }
+    }
+
+    if(kind == p_loadavg) break;
+    p = (end == last? last: end + 1);
+  }
+
+  // counters are reported as differences
+  switch(kind)
+  {
+  case p_meminfo:
+  case p_loadavg:
+    std::copy(raw.begin(), raw.end(), out.begin());
+    break;
+
+  case p_vmstat:
+  case p_net:
+    for(size_t i = 0; i != raw.size(); ++i)
+      out[i] = raw[i] - old[i];
+    break;
+
+  case p_stat:
+    for(size_t k = 0; k != keys.size(); ++k)
+    {
+      const double* v = &raw[k * 2];
+      const double* o = &old[k * 2];
+      if(keys[k].compare(0, 3, "cpu"))
+	out[k] = v[0] - o[0];
+      else
+	out[k] = 100. * (v[0] - o[0]) / (v[1] - o[1]);
+    }
+    break;
+  }
+
+  std::copy(raw.begin(), raw.end(), old.begin());
+  if(!primed && kind != p_meminfo && kind != p_loadavg)
+  {
+    primed = true;
+    return true;
+  }
+
+  // a complete frame at each sample
+  const size_t count = feed.size();
+  for(size_t i = 0; i != count; ++i)
+    feed.value(i < out.size()? out[i]: NAN);
+
+  feed.commit();
+  return true;
+}
+
+
+bool
+Proc::ready()
+{
+  // missed ticks are not recovered
+  uint64_t ticks;
+  if(::read(fd, &ticks, sizeof(ticks)) < 0 && errno != EAGAIN)
+    return false;
+
+  return sample();
+}
+
+
+/*
+ * Synth
+ */
+
+Synth::Synth(const string& name, const Feed& feed)
+: Source(name), feed(feed), rate(Trend::synthRate), start(0), frames(0),
+  seed(88172645463325252ULL)
+{
+  string spec;
+  hasScheme(name, "synth:", spec);
+  if(spec.size())
+    rate = (spec == "max"? 0.: strtod(spec.c_str(), NULL));
+}
+
+
+Synth::~Synth()
+{
+  if(fd >= 0)
+    ::close(fd);
+}
+
+
+bool
+Synth::open(Loop& loop)
+{
+  this->loop = &loop;
+  if(!(rate >= 0.))
+    return false;
+  start = monotonic();
+
+  // the timer is not needed at maximum rate (always ready)
+  if(rate > 0.)
+  {
+    itimerspec ts;
+    long ns = static_cast<long>(1e9 / std::min(rate, 1. * Trend::synthTick));
+    ts.it_interval.tv_sec = ns / 1000000000;
+    ts.it_interval.tv_nsec = ns % 1000000000;
+    ts.it_value = ts.it_interval;
+
+    if((fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)) < 0 ||
+	timerfd_settime(fd, 0, &ts, NULL))
+      return false;
+  }
+
+  loop.watch(this);
+  return true;
+}
+
+
+bool
+Synth::ready()
+{
+  uint64_t ticks;
+  if(fd >= 0 && ::read(fd, &ticks, sizeof(ticks)) < 0 && errno != EAGAIN)
+    return false;
+
+  // frames due so far, bounded to keep the loop responsive
+  uint64_t due = frames + Trend::synthBatch;
+  if(rate > 0.)
+    due = std::min(due, static_cast<uint64_t>(
+	  (monotonic() - start) * 1e-9 * rate));
+
+  const size_t count = feed.size();
+  for(; frames < due; ++frames)
+    for(size_t i = 0; i != count; ++i)
+    {
+      // xorshift64*
+      seed ^= seed >> 12;
+      seed ^= seed << 25;
+      seed ^= seed >> 27;
+      double noise = (seed * 2685821657736338717ULL >> 11) *
+	(1. / 9007199254740992.);
+
+      feed.value(sin(frames * .01 * (i + 1)) * 100. + noise * 10.);
+    }
+
+  feed.commit();
+  return true;
+}
+
+
+/*
+ * Replay
+ */
+
+Replay::Replay(const string& name, Trend::format_t format, const Feed& feed)
+: Source(name), format(format), feed(feed), file(NULL), which(0), speed(1.),
+  start(0), eof(false)
+{
+  hasScheme(name, "replay:", path);
+
+  // optional speed
+  string::size_type p = path.rfind('@');
+  if(p != string::npos)
+  {
+    string s(path.substr(p + 1));
+    speed = (s == "max"? 0.: strtod(s.c_str(), NULL));
+    path.erase(p);
+  }
+
+  // optional input number
+  p = path.rfind(':');
+  if(p != string::npos && p + 1 != path.size() &&
+      strspn(path.c_str() + p + 1, "0123456789") == path.size() - p - 1)
+  {
+    which = strtoul(path.c_str() + p + 1, NULL, 10);
+    path.erase(p);
+  }
+}
+
+
+Replay::~Replay()
+{
+  if(file)
+    fclose(file);
+  if(fd >= 0)
+    ::close(fd);
+}
+
+
+bool
+Replay::open(Loop& loop)
+{
+  this->loop = &loop;
+
+  char magic[sizeof(recMagic)];
+  if(!(speed >= 0.) || !(file = fopen(path.c_str(), "rb")) ||
+      fread(magic, sizeof(magic), 1, file) != 1 ||
+      memcmp(magic, recMagic, sizeof(magic)))
+    return false;
+
+  start = monotonic();
+  eof = !fetch();
+
+  // the timer is not needed at maximum speed (always ready)
+  if(speed > 0.)
+  {
+    if((fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)) < 0)
+      return false;
+    arm(eof? 0: next.time);
+  }
+
+  loop.watch(this);
+  return true;
+}
+
+
+// read the next record header for our input
+bool
+Replay::fetch()
+{
+  while(fread(&next, sizeof(next), 1, file) == 1)
+  {
+    if(next.input == which)
+      return true;
+    if(next.len && fseeko(file, next.len, SEEK_CUR))
+      break;
+  }
+
+  return false;
+}
+
+
+// schedule the timer for the record at "time"
+void
+Replay::arm(uint64_t time)
+{
+  uint64_t t = start + static_cast<uint64_t>(time / speed);
+
+  itimerspec ts;
+  memset(&ts, 0, sizeof(ts));
+  ts.it_value.tv_sec = t / 1000000000;
+  ts.it_value.tv_nsec = t % 1000000000;
+  timerfd_settime(fd, TFD_TIMER_ABSTIME, &ts, NULL);
+}
+
+
+Replay::Channel&
+Replay::get(unsigned id)
+{
+  for(vector<Channel>::iterator it = channels.begin();
+      it != channels.end(); ++it)
+    if(it->id == id)
+      return *it;
+
+  channels.push_back(Channel(id, format, feed));
+  return channels.back();
+}
+
+
+bool
+Replay::ready()
+{
+  uint64_t ticks;
+  if(fd >= 0 && ::read(fd, &ticks, sizeof(ticks)) < 0 && errno != EAGAIN)
+    return false;
+
+  const uint64_t now = monotonic() - start;
+  for(int n = 0; !eof; ++n)
+  {
+    // wait for the next record, or yield to the other sources
+    if(speed > 0. && next.time / speed > now)
+    {
+      arm(next.time);
+      return true;
+    }
+    if(speed == 0. && n == Trend::maxEvents)
+      return true;
+
+    if(data.size() < next.len)
+      data.resize(next.len);
+    if(next.len && fread(&data[0], next.len, 1, file) != 1)
+      return false;
+
+    // the same handling as the original source
+    Channel& c = get(next.channel);
+    if(next.len) c.feed.parse(c.parser, &data[0], &data[0] + next.len);
+    if(next.flags & Recorder::r_datagram)
+    {
+      c.parser.flush(c.feed);
+      c.feed.align();
+    }
+    if(next.flags & Recorder::r_align)
+    {
+      c.parser.reset();
+      c.feed.align();
+    }
+    if(next.flags & Recorder::r_end)
+    {
+      c.parser.reset();
+      c.feed.reset();
+    }
+    c.feed.commit();
+
+    eof = !fetch();
+  }
+
+  return false;
+}
+
+
+/*
+ * Control
+ */
+
+Control::Control(const string& name, const Hooks* hooks)
+: Source(name), hooks(hooks), listening(false), connected(false), len(0),
+  skip(false)
+{}
+
+
+Control::Control(const string& name, int fd, const Hooks* hooks)
+: Source(name), hooks(hooks), listening(false), connected(true), len(0),
+  skip(false)
+{
+  this->fd = fd;
+}
+
+
+Control::~Control()
+{
+  if(fd >= 0)
+    ::close(fd);
+  if(path.size())
+    unlink(path.c_str());
+}
+
+
+bool
+Control::open(Loop& loop)
+{
+  this->loop = &loop;
+
+  string addr;
+  if(fd >= 0)
+  {
+    // accepted connection
+  }
+  else if(hasScheme(name, "unix:", addr))
+  {
+    if((fd = unixSocket(addr, SOCK_STREAM)) < 0)
+      return false;
+    path = addr;
+    listening = true;
+  }
+  else
+  {
+    // a fifo created here is also removed on exit
+    if(!mkfifo(name.c_str(), 0600))
+      path = name;
+    else if(errno != EEXIST)
+      return false;
+
+    // open for writing too, so that EOF is never seen between writers
+    struct stat stBuf;
+    if((fd = ::open(name.c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC)) < 0 ||
+	fstat(fd, &stBuf) || !S_ISFIFO(stBuf.st_mode))
+      return false;
+  }
+
+  if(!listening)
+  {
+    buf.resize(Trend::maxLineLen);
+    line.resize(Trend::maxLineLen);
+  }
+
+  loop.watch(this);
+  return true;
+}
+
+
+void
+Control::dispatch(const char* p, size_t n)
+{
+  reply.clear();
+  hooks->control(p, n, reply);
+
+  // replies are short: partial writes are not retried
+  if(reply.size() && connected)
+  {
+    ssize_t ret = send(fd, reply.data(), reply.size(), MSG_NOSIGNAL);
+    (void)ret;
+  }
+}
+
+
+void
+Control::feed(const char* p, const char* end)
+{
+  while(p != end)
+  {
+    const char* nl = static_cast<const char*>(memchr(p, '\n', end - p));
+    const char* e = (nl? nl: end);
+
+    // overlong lines are discarded
+    size_t n = e - p;
+    if(len + n > line.size()) skip = true;
+    else if(!skip)
+    {
+      memcpy(&line[len], p, n);
+      len += n;
+    }
+    if(!nl) return;
+
+    if(!skip) dispatch(&line[0], len);
+    len = 0;
+    skip = false;
+    p = nl + 1;
+  }
+}
+
+
+bool
+Control::ready()
+{
+  if(listening)
+  {
+    for(int i = 0; i != Trend::maxEvents; ++i)
+    {
+      int cfd = accept4(fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+      if(cfd < 0)
+	return (errno != EBADF && errno != EINVAL);
+
+      loop->add(new Control(name, cfd, hooks));
+    }
+    return true;
+  }
+
+  ssize_t n = ::read(fd, &buf[0], buf.size());
+  if(n > 0)
+  {
+    feed(&buf[0], &buf[0] + n);
+    return true;
+  }
+  if(n < 0 && (errno == EAGAIN || errno == EINTR))
+    return true;
+
+  // closed connection: the last line needs no terminator
+  if(len && !skip) dispatch(&line[0], len);
+  return false;
+}
+
+
+/*
+ * Metrics
+ */
+
+Metrics::Metrics(const string& name, void (*format)(string&))
+: Source(name), format(format), listening(false), len(0)
+{}
+
+
+Metrics::Metrics(const string& name, int fd, void (*format)(string&))
+: Source(name), format(format), listening(false), len(0)
+{
+  this->fd = fd;
+}
+
+
+Metrics::~Metrics()
+{
+  if(fd >= 0)
+    ::close(fd);
+  if(path.size())
+    unlink(path.c_str());
+}
+
+
+bool
+Metrics::open(Loop& loop)
+{
+  this->loop = &loop;
+
+  string addr;
+  if(fd >= 0)
+    buf.resize(Trend::maxLineLen);
+  else
+  {
+    if(hasScheme(name, "unix:", addr))
+    {
+      if((fd = unixSocket(addr, SOCK_STREAM)) >= 0)
+	path = addr;
+    }
+    else if(hasScheme(name, "tcp:", addr))
+      fd = inetSocket(addr, SOCK_STREAM);
+
+    if(fd < 0)
+      return false;
+    listening = true;
+  }
+
+  loop.watch(this);
+  return true;
+}
+
+
+void
+Metrics::respond()
+{
+  string body;
+  format(body);
+
+  char head[256];
+  int n = snprintf(head, sizeof(head),
+      "HTTP/1.0 200 OK\r\n"
+      "Content-Type: text/plain; version=0.0.4\r\n"
+      "Content-Length: %lu\r\n"
+      "Connection: close\r\n\r\n",
+      static_cast<unsigned long>(body.size()));
+  body.insert(0, head, n);
+
+  // this loop runs on its own thread: write in blocking mode, up to a timeout
+  timeval tv = {Trend::metricsTimeout, 0};
+  setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_NONBLOCK);
+
+  for(size_t p = 0; p != body.size();)
+  {
+    ssize_t ret = send(fd, body.data() + p, body.size() - p, MSG_NOSIGNAL);
+    if(ret <= 0) break;
+    p += ret;
+  }
+}
+
+
+bool
+Metrics::ready()
+{
+  if(listening)
+  {
+    for(int i = 0; i != Trend::maxEvents; ++i)
+    {
+      int cfd = accept4(fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+      if(cfd < 0)
+	return (errno != EBADF && errno != EINVAL);
+
+      loop->add(new Metrics(name, cfd, format));
+    }
+    return true;
+  }
+
+  ssize_t n = ::read(fd, &buf[len], buf.size() - len);
+  if(n < 0)
+    return (errno == EAGAIN || errno == EINTR);
+  if(n == 0)
+    return false;
+
+  // wait for the end of the request headers (overlong requests are answered)
+  len += n;
+  if(len != buf.size() && !memmem(&buf[0], len, "\n\r\n", 3) &&
+      !memmem(&buf[0], len, "\n\n", 2))
+    return true;
+
+  respond();
+  return false;
+}
+
+
+/*
+ * Loop
+ */
+
+Loop::Loop()
+{
+  ep = epoll_create1(EPOLL_CLOEXEC);
+}
+
+
+Loop::~Loop()
+{
+  while(sources.size())
+    remove(sources.back());
+  if(ep >= 0) ::close(ep);
+}
+
+
+bool
+Loop::add(Source* src)
+{
+  sources.push_back(src);
+  if(src->open(*this))
+    return true;
+
+  remove(src);
+  return false;
+}
+
+
+void
+Loop::remove(Source* src)
+{
+  unwatch(src);
+  sources.erase(std::find(sources.begin(), sources.end(), src));
+  delete src;
+}
+
+
+void
+Loop::watch(Source* src)
+{
+  epoll_event ev;
+  ev.events = EPOLLIN;
+  ev.data.ptr = src;
+
+  // regular files cannot be polled, and are always ready
+  if(epoll_ctl(ep, EPOLL_CTL_ADD, src->fd, &ev))
+    pending(src, true);
+}
+
+
+void
+Loop::unwatch(Source* src)
+{
+  pending(src, false);
+  if(src->fd >= 0)
+    epoll_ctl(ep, EPOLL_CTL_DEL, src->fd, NULL);
+}
+
+
+void
+Loop::pending(Source* src, bool on)
+{
+  vector<Source*>::iterator it = std::find(busy.begin(), busy.end(), src);
+  if(on && it == busy.end())
+    busy.push_back(src);
+  else if(!on && it != busy.end())
+    busy.erase(it);
+}
+
+
+void
+Loop::run()
+{
+  epoll_event evs[Trend::maxEvents];
+
+  while(sources.size())
+  {
+    // don't wait while there are always-ready sources
+    int n = epoll_wait(ep, evs, Trend::maxEvents, (busy.size()? 0: -1));
+    if(n < 0 && errno != EINTR)
+      break;
+
+    for(int i = 0; i < n; ++i)
+    {
+      Source* src = static_cast<Source*>(evs[i].data.ptr);
+      if(!src->ready())
+	remove(src);
+    }
+
+    // serve always-ready sources in turn
+    vector<Source*> now(busy);
+    for(vector<Source*>::iterator it = now.begin(); it != now.end(); ++it)
+      if(!(*it)->ready())
+	remove(*it);
+  }
+}
+
+
+/*
+ * Source factory
+ */
+
+Source*
+newSource(const string& name, Trend::format_t format, const Feed& feed)
+{
+  string addr;
+  if(hasScheme(name, "udp:", addr))
+    return new Datagram(name, format, feed);
+  if(hasScheme(name, "tcp:", addr) || hasScheme(name, "unix:", addr))
+    return new Listener(name, format, feed);
+  if(hasScheme(name, "follow:", addr))
+    return new Follow(name, format, feed);
+  if(hasScheme(name, "shm:", addr))
+    return new Shm(name, feed);
+  if(hasScheme(name, "proc:", addr))
+    return new Proc(name, feed);
+  if(hasScheme(name, "replay:", addr))
+    return new Replay(name, format, feed);
+  if(hasScheme(name, "synth:", addr))
+    return new Synth(name, feed);
+
+  Inflate::codec_t codec;
+  if(Inflate::detect(name, codec))
+    return new Inflate(name, codec, format, feed);
+  if(format == Trend::f_ascii && Chunked::detect(name))
+    return new Chunked(name, feed);
+
+  return new Stream(name, format, feed);
+}
@@ -0,0 +1,912 @@
+/*
+ * input: input sources and producer event loop
+ * Copyright(c) 2018 by wave++ "Yuri D'Elia" <wavexx@thregr.org>
+ * Distributed under GNU LGPL WITHOUT ANY WARRANTY.
+ */
+
+#ifndef input_hh
+#define input_hh
+
+// defaults
+#include "defaults.hh"
+#include "parser.hh"
+#include "rr.hh"
+#include "names.hh"
+#include "trendshm.h"
+#include "queue.hh"
+#include "timer.hh"
+#include "profile.hh"
+
+// system headers
+#include <string>
+#include <vector>
+
+// c system headers
+#include <math.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+
+
+class Loop;
+
+
+// escape/control command (see readme/manual for the sequence format)
+struct Command
+{
+  Trend::command_t code;
+  size_t graph;
+  size_t pos;
+  double args[2];
+
+  // remote control operation and argument (c_control)
+  size_t op;
+  char str[Trend::maxNumLen];
+};
+
+
+// producer/display counters (updated atomically, readable from any thread)
+struct Stats
+{
+  uint64_t samples;	// values appended to the graphs
+  uint64_t overruns;	// values overwritten before being ever displayed
+  uint64_t errors;	// unparsable values/lines skipped
+  uint64_t blocked;	// time the producer waited for the display (ns)
+  uint64_t dropped;	// frames dropped by the output
+  uint64_t vidFrames;	// frames written to the video output
+  uint64_t vidDrops;	// frames dropped by the video output
+  uint64_t cmdDrops;	// commands dropped as the display queue was full
+
+  // input to display latency over the last period (ns)
+  uint64_t latP50;
+  uint64_t latP99;
+  uint64_t latMax;
+
+  // frames drawn, and their drawing time over the last period (ns)
+  uint64_t frames;
+  uint64_t frameP50;
+  uint64_t frameP99;
+  uint64_t frameMax;
+};
+
+
+// producer hooks (called from within the producer thread)
+struct Hooks
+{
+  // new complete frames are available (the oldest received at "stamp")
+  void (*notify)(uint64_t stamp);
+
+  // a graph was claimed by a new series
+  void (*relabel)(size_t graph, const std::string& label);
+
+  // an escape command was received (false if dropped)
+  bool (*command)(const Command& cmd);
+
+  // a remote control line was received (the reply, if any, is returned)
+  void (*control)(const char* line, size_t len, std::string& reply);
+
+  // shared counters
+  Stats* stats;
+
+  // stage timings
+  Profile* profile;
+};
+
+
+/*
+ * Maps series names to graphs (relative to a feed). Names not matching any
+ * label claim the next unlabeled graph, if any, and are dropped otherwise.
+ * Routers are shared by all the feeds of a source.
+ */
+class Router
+{
+  Names names;
+  std::vector<size_t> free;
+  size_t next;
+  size_t base;
+  void (*relabel)(size_t, const std::string&);
+
+public:
+  Router(size_t base, const std::vector<std::string>& labels,
+      void (*relabel)(size_t, const std::string&));
+
+  // return the graph for the series name, or Names::npos
+  size_t
+  route(const char* name, size_t len)
+  {
+    size_t i = names.find(name, len);
+    if(i == Names::npos && next != free.size())
+    {
+      i = free[next++];
+      names.insert(name, len, i);
+      relabel(base + i, std::string(name, len));
+    }
+    return i;
+  }
+};
+
+
+/*
+ * Output sink for processed frames (native doubles, optionally decimated).
+ * Frames are batched into blocks, written by a background thread: when the
+ * writer can't keep up, frames are dropped instead of stalling the producer.
+ * Blocks hold at least one frame of "width" values.
+ */
+class Sink
+{
+  std::string path;
+  size_t decimate;
+  size_t blockSize;
+  Stats* stats;
+  size_t frames;
+  int wake;
+  bool stop;
+  bool started;
+  pthread_t thread;
+  std::vector<char> blocks;
+  std::vector<size_t> lens;
+  Queue<size_t> full;
+  Queue<size_t> empty;
+  size_t cur;
+  size_t used;
+
+  char*
+  block(size_t i)
+  {
+    return &blocks[i * blockSize];
+  }
+
+  static void* run(void* arg);
+  void work();
+
+public:
+  Sink(const std::string& path, size_t decimate, size_t width, Stats* stats);
+  ~Sink();
+
+  bool open();
+
+  // append a frame (from the producer thread)
+  void
+  frame(const double* v, size_t n)
+  {
+    if(++frames % decimate)
+      return;
+
+    const size_t len = n * sizeof(double);
+    if(used + len > blockSize)
+      flush();
+    if(len > blockSize || (cur == Names::npos && !empty.pop(cur)))
+    {
+      __atomic_add_fetch(&stats->dropped, 1, __ATOMIC_RELAXED);
+      return;
+    }
+
+    memcpy(block(cur) + used, v, len);
+    used += len;
+  }
+
+  // pass the current batch to the writer
+  void flush();
+};
+
+
+/*
+ * A feed maps a sequence of values to a range of graphs, handling the
+ * interleaving of multiple graphs and the counting mode. Frames are
+ * committed in batches (usually once per read) to reduce notifications.
+ */
+class Feed
+{
+  rr<Trend::Value>* const* data;
+  size_t first;
+  size_t count;
+  Trend::input_t input;
+  bool esc;
+  const Hooks* hooks;
+  Router* router;
+  Sink* sink;
+
+  std::vector<double> old;
+  std::vector<double> last;
+  std::vector<bool> seen;
+  size_t col;
+  bool primed;
+  size_t frames;
+  size_t samples;
+  size_t errors;
+  uint64_t stamp;
+  size_t period;
+  size_t left;
+
+  // escape sequence state
+  int escState;
+  size_t escArg;
+  size_t escNeed;
+  Command cmd;
+
+  bool escape(double v);
+  void dispatch();
+
+  // determine the actual value
+  void
+  convert(size_t i, double& v)
+  {
+    switch(input)
+    {
+    case Trend::incremental:
+      {
+	double tmp = v;
+	v -= old[i];
+	old[i] = tmp;
+      }
+      break;
+
+    case Trend::differential:
+      old[i] += v;
+      v = old[i];
+      break;
+
+    default:;
+    }
+  }
+
+public:
+  Feed(rr<Trend::Value>* const* rings, size_t first, size_t count,
+      Trend::input_t input, bool esc, const Hooks* hooks,
+      Router* router = NULL);
+
+  // also write complete frames to the sink
+  void
+  output(Sink* sink)
+  {
+    this->sink = sink;
+    last.resize(sink? count: 0);
+  }
+
+  // also commit every n complete frames (0 to commit per chunk only)
+  void
+  every(size_t n)
+  {
+    period = left = n;
+  }
+
+  // number of graphs
+  size_t
+  size() const
+  {
+    return count;
+  }
+
+  // restart from the first graph (discarding partial frames)
+  void
+  reset()
+  {
+    col = 0;
+    primed = false;
+    seen.assign(seen.size(), false);
+    escState = 0;
+  }
+
+  // discard a partial frame, but keep reference values
+  void
+  align()
+  {
+    col = 0;
+  }
+
+  // a named sample (each graph is independent)
+  void
+  named(const char* name, size_t len, double v)
+  {
+    size_t i = router->route(name, len);
+    if(i == Names::npos || (esc && isinf(v)))
+      return;
+
+    if(input != Trend::absolute && !seen[i])
+    {
+      old[i] = v;
+      seen[i] = true;
+      return;
+    }
+
+    convert(i, v);
+    data[i]->push_back(v);
+    ++samples;
+    ++frames;
+    if(__builtin_expect(period != 0, 0) && !--left) sync();
+  }
+
+  // unparsable input skipped
+  void
+  error(size_t n = 1)
+  {
+    errors += n;
+  }
+
+  void
+  value(double v)
+  {
+    // escape sequences (a single, rarely taken branch)
+    if(__builtin_expect(isinf(v) | (escState != 0), 0) && escape(v))
+      return;
+
+    // first value for incremental data
+    if(input != Trend::absolute && !primed)
+    {
+      old[col] = v;
+      if(++col == count)
+      {
+	col = 0;
+	primed = true;
+      }
+      return;
+    }
+
+    // append the value
+    convert(col, v);
+    data[col]->push_back(v);
+    ++samples;
+    if(sink) last[col] = v;
+    if(++col == count)
+    {
+      col = 0;
+      ++frames;
+      if(sink) sink->frame(&last[0], count);
+      if(__builtin_expect(period != 0, 0) && !--left) sync();
+    }
+  }
+
+  // convert a chunk of input
+  void
+  parse(Parser& parser, const char* p, const char* end)
+  {
+    // arrival time of the oldest data not yet notified
+    if(!stamp) stamp = monotonic();
+
+    uint64_t t = hooks->profile->start();
+    parser.feed(p, end, *this);
+    hooks->profile->lap(Profile::s_parse, t);
+  }
+
+  // account and notify complete frames
+  void
+  commit()
+  {
+    if(samples | errors)
+    {
+      __atomic_add_fetch(&hooks->stats->samples, samples, __ATOMIC_RELAXED);
+      __atomic_add_fetch(&hooks->stats->errors, errors, __ATOMIC_RELAXED);
+      samples = errors = 0;
+    }
+    if(frames)
+    {
+      frames = 0;
+      if(sink) sink->flush();
+      uint64_t t = hooks->profile->start();
+      hooks->notify(stamp? stamp: monotonic());
+      hooks->profile->lap(Profile::s_commit, t);
+      stamp = 0;
+    }
+  }
+
+  // commit at a frame boundary within a chunk
+  void
+  sync()
+  {
+    left = period;
+    commit();
+  }
+};
+
+
+// recording header and record header (native byte order)
+const char recMagic[8] = {'T', 'R', 'N', 'D', 'R', 'E', 'C', '1'};
+
+struct RecordHeader
+{
+  uint64_t time;	// arrival time (ns since the start of the recording)
+  uint32_t len;		// length of the data following the header
+  uint8_t input;	// input number (in command-line order)
+  uint8_t flags;	// Recorder::flags_t
+  uint16_t channel;	// connection within the input
+};
+
+
+/*
+ * Input recorder: the raw bytes of each read, along with their monotonic
+ * arrival time. Records are buffered and written by the producer thread.
+ */
+class Recorder
+{
+  FILE* file;
+  uint64_t start;
+  unsigned channels;
+
+public:
+  enum flags_t {r_datagram = 1, r_align = 2, r_end = 4};
+
+  Recorder()
+  : file(NULL), channels(0)
+  {}
+
+  ~Recorder();
+
+  bool open(const char* path);
+
+  // allocate a new channel
+  unsigned
+  channel()
+  {
+    return channels++;
+  }
+
+  void write(unsigned input, unsigned channel, int flags, const char* p,
+      size_t len);
+};
+
+
+/*
+ * Generic event source
+ */
+class Source
+{
+protected:
+  Loop* loop;
+  std::string name;
+  Recorder* rec;
+  unsigned input;
+  unsigned channel;
+
+  // record data as received
+  void
+  record(const char* p, size_t len, int flags = 0)
+  {
+    if(rec) rec->write(input, channel, flags, p, len);
+  }
+
+public:
+  int fd;
+
+  explicit
+  Source(const std::string& name)
+  : loop(NULL), name(name), rec(NULL), input(0), channel(0), fd(-1)
+  {}
+
+  virtual ~Source();
+
+  const std::string&
+  getName() const
+  {
+    return name;
+  }
+
+  // record the data of this source as input number "input"
+  void
+  tap(Recorder* rec, unsigned input)
+  {
+    this->rec = rec;
+    this->input = input;
+    if(rec) channel = rec->channel();
+  }
+
+  // open the source and register it within the loop
+  virtual bool open(Loop& loop) = 0;
+
+  // handle a readiness event. Return false when the source is exhausted
+  virtual bool ready() = 0;
+};
+
+
+/*
+ * Byte-stream source (file, fifo, stdin or connected socket), with its own
+ * buffering and parser state.
+ */
+class Stream: public Source
+{
+  Parser parser;
+  Feed feed;
+  bool reopen;
+  std::vector<char> buf;
+
+  bool openFd();
+  void closeFd();
+
+public:
+  Stream(const std::string& name, Trend::format_t format, const Feed& feed);
+  Stream(const std::string& name, int fd, Trend::format_t format,
+      const Feed& feed);
+  ~Stream();
+
+  bool open(Loop& loop);
+  bool ready();
+};
+
+
+/*
+ * Compressed regular file (gzip or zstd, detected from the magic number).
+ * Decompression runs on a separate thread, which fills a fixed ring of blocks
+ * consumed by the loop: decompression and parsing thus overlap.
+ */
+class Inflate: public Source
+{
+public:
+  enum codec_t {gzip, zstd};
+
+private:
+  Parser parser;
+  Feed feed;
+  codec_t codec;
+  int file;
+  int wake;
+  bool stop;
+  bool done;
+  bool started;
+  pthread_t thread;
+  std::vector<char> blocks;
+  std::vector<size_t> lens;
+  Queue<size_t> full;
+  Queue<size_t> empty;
+
+  // decompression thread
+  static void* run(void* arg);
+  size_t take();
+  char* block(size_t i);
+  void give(size_t i, size_t len);
+  void inflateGzip();
+  void inflateZstd();
+
+public:
+  Inflate(const std::string& name, codec_t codec, Trend::format_t format,
+      const Feed& feed);
+  ~Inflate();
+
+  // detect a supported compressed file
+  static bool detect(const std::string& name, codec_t& codec);
+
+  bool open(Loop& loop);
+  bool ready();
+};
+
+
+/*
+ * Large regular ASCII file, parsed in parallel. The file is mapped and split
+ * into chunks at line boundaries: chunks are converted by a pool of workers
+ * and the resulting values are fed in order, so that frames spanning several
+ * chunks are preserved.
+ */
+class Chunked: public Source
+{
+  struct Chunk
+  {
+    std::vector<double> values;
+    size_t errors;
+    bool ready;
+  };
+
+  Feed feed;
+  const char* map;
+  size_t len;
+  std::vector<size_t> bounds;
+  std::vector<Chunk> slots;
+  std::vector<pthread_t> workers;
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+  size_t next;
+  size_t cur;
+  bool stop;
+
+  static void* run(void* arg);
+  void work();
+
+public:
+  Chunked(const std::string& name, const Feed& feed);
+  ~Chunked();
+
+  // check if the file is large enough to be worth splitting
+  static bool detect(const std::string& name);
+
+  bool open(Loop& loop);
+  bool ready();
+};
+
+
+/*
+ * Stream listener (tcp:[host:]port or unix:path). Each accepted connection
+ * becomes an independent stream feeding the same graphs.
+ */
+class Listener: public Source
+{
+  Trend::format_t format;
+  Feed feed;
+  std::string path;
+
+public:
+  Listener(const std::string& name, Trend::format_t format, const Feed& feed);
+  ~Listener();
+
+  bool open(Loop& loop);
+  bool ready();
+};
+
+
+/*
+ * Datagram source (udp:[host:]port). Each datagram contains one or more
+ * complete frames. Datagrams are received in batches.
+ */
+class Datagram: public Source
+{
+  Parser parser;
+  Feed feed;
+  std::vector<char> buf;
+  std::vector<iovec> iov;
+  std::vector<mmsghdr> msgs;
+
+public:
+  Datagram(const std::string& name, Trend::format_t format, const Feed& feed);
+  ~Datagram();
+
+  bool open(Loop& loop);
+  bool ready();
+};
+
+
+/*
+ * Growing regular file (follow:path), in the style of "tail -F". New data is
+ * waited for using inotify. Truncation restarts the file from the beginning,
+ * while rotation (a new file replacing the path) switches to the new file once
+ * the old one is completely consumed.
+ */
+class Follow: public Source
+{
+  Parser parser;
+  Feed feed;
+  std::vector<char> buf;
+  std::string path;
+  int file;
+  int wd;
+  dev_t dev;
+  ino_t ino;
+  off_t offset;
+
+  bool openFile();
+  void closeFile();
+  bool check();
+
+public:
+  Follow(const std::string& name, Trend::format_t format, const Feed& feed);
+  ~Follow();
+
+  bool open(Loop& loop);
+  bool ready();
+};
+
+
+/*
+ * Shared-memory ring (shm:/name, see trendshm.h). Frames are binary and
+ * copied directly from the writer's ring at each tick of a timer. The layout
+ * validated when mapping is kept: the object is mapped again when the writer
+ * restarts with a different one.
+ */
+class Shm: public Source
+{
+  Feed feed;
+  int obj;
+  const trend_shm* shm;
+  size_t len;
+  uint32_t columns;
+  uint64_t size;
+  uint64_t cur;
+  std::vector<double> buf;
+
+  bool map();
+
+public:
+  Shm(const std::string& name, const Feed& feed);
+  ~Shm();
+
+  bool open(Loop& loop);
+  bool ready();
+};
+
+
+/*
+ * Built-in /proc sampler (proc:file[:key,...][@rate]). The file is kept open
+ * and re-read at each tick of a timer into a fixed buffer: keys are looked up
+ * in-place, so that no allocation is performed while sampling.
+ */
+class Proc: public Source
+{
+public:
+  enum kind_t {p_meminfo, p_vmstat, p_net, p_stat, p_loadavg};
+
+private:
+  Feed feed;
+  kind_t kind;
+  const char* path;
+  size_t width;
+  int file;
+  double rate;
+  bool primed;
+  std::vector<char> buf;
+  std::vector<std::string> keys;
+  std::vector<double> raw;
+  std::vector<double> old;
+  std::vector<double> out;
+
+  size_t find(const char* s, size_t len) const;
+  bool sample();
+
+public:
+  Proc(const std::string& name, const Feed& feed);
+  ~Proc();
+
+  bool open(Loop& loop);
+  bool ready();
+};
+
+
+/*
+ * Synthetic generator (synth:[rate]), producing noisy sines of increasing
+ * frequency for each graph at the given number of frames per second (or as
+ * fast as possible with a rate of 0/max). The frames due since the start are
+ * produced in batches at each tick of a timer, so that the rate is kept on
+ * average independently of the timer resolution.
+ */
+class Synth: public Source
+{
+  Feed feed;
+  double rate;
+  uint64_t start;
+  uint64_t frames;
+  uint64_t seed;
+
+public:
+  Synth(const std::string& name, const Feed& feed);
+  ~Synth();
+
+  bool open(Loop& loop);
+  bool ready();
+};
+
+
+/*
+ * Recording replay (replay:file[:input][@speed]). Records of the given input
+ * (0 by default) are fed back with the original timing, scaled by speed, or
+ * as fast as possible with a speed of 0/max.
+ */
+class Replay: public Source
+{
+  struct Channel
+  {
+    unsigned id;
+    Parser parser;
+    Feed feed;
+
+    Channel(unsigned id, Trend::format_t format, const Feed& feed)
+    : id(id), parser(format), feed(feed)
+    {}
+  };
+
+  Trend::format_t format;
+  Feed feed;
+  std::string path;
+  FILE* file;
+  unsigned which;
+  double speed;
+  uint64_t start;
+  RecordHeader next;
+  bool eof;
+  std::vector<char> data;
+  std::vector<Channel> channels;
+
+  bool fetch();
+  void arm(uint64_t time);
+  Channel& get(unsigned id);
+
+public:
+  Replay(const std::string& name, Trend::format_t format, const Feed& feed);
+  ~Replay();
+
+  bool open(Loop& loop);
+  bool ready();
+};
+
+
+/*
+ * Remote control interface (a fifo, or unix:path for a listening socket).
+ * Each line received is a command, passed as-is to the control hook. Socket
+ * connections are independent and also receive replies to queries.
+ */
+class Control: public Source
+{
+  const Hooks* hooks;
+  bool listening;
+  bool connected;
+  std::string path;
+  std::vector<char> buf;
+  std::vector<char> line;
+  size_t len;
+  bool skip;
+  std::string reply;
+
+  void dispatch(const char* p, size_t n);
+  void feed(const char* p, const char* end);
+
+public:
+  Control(const std::string& name, const Hooks* hooks);
+  Control(const std::string& name, int fd, const Hooks* hooks);
+  ~Control();
+
+  bool open(Loop& loop);
+  bool ready();
+};
+
+
+/*
+ * Metrics endpoint (unix:path or tcp:[host:]port). Each connection receives
+ * the output of the format function as an HTTP response (Prometheus text
+ * format) once the request headers are complete, whatever the request.
+ */
+class Metrics: public Source
+{
+  void (*format)(std::string& out);
+  bool listening;
+  std::string path;
+  std::vector<char> buf;
+  size_t len;
+
+  void respond();
+
+public:
+  Metrics(const std::string& name, void (*format)(std::string& out));
+  Metrics(const std::string& name, int fd,
+      void (*format)(std::string& out));
+  ~Metrics();
+
+  bool open(Loop& loop);
+  bool ready();
+};
+
+
+/*
+ * Single-threaded event loop. Sources are read in non-blocking mode and served
+ * in turn, so a slow source never stalls the others. Descriptors which cannot
+ * be polled (regular files) are considered always ready.
+ */
+class Loop
+{
+  int ep;
+  std::vector<Source*> sources;
+  std::vector<Source*> busy;
+
+  void remove(Source* src);
+
+public:
+  Loop();
+  ~Loop();
+
+  // add a new source (the loop takes ownership)
+  bool add(Source* src);
+
+  // register/unregister the current source descriptor
+  void watch(Source* src);
+  void unwatch(Source* src);
+
+  // flag sources with pending data (always ready)
+  void pending(Source* src, bool on);
+
+  // run until all sources are exhausted
+  void run();
+};
+
+
+// create a new source according to the name/scheme
+Source*
+newSource(const std::string& name, Trend::format_t format, const Feed& feed);
+
+
+#endif
@@ -0,0 +1,97 @@
+/*
+ * names: fixed-capacity string to index hash table
+ * Copyright(c) 2018 by wave++ "Yuri D'Elia" <wavexx@thregr.org>
+ * Distributed under GNU LGPL WITHOUT ANY WARRANTY.
+ */
+
+#ifndef names_hh
+#define names_hh
+
+// system headers
+#include <string>
+#include <vector>
+
+// c system headers
+#include <stdint.h>
+#include <string.h>
+
+
+/*
+ * Open-addressing hash table with linear probing. The capacity is fixed at
+ * construction (there are never more names than graphs), so that lookups are
+ * a single hash computation followed, in the common case, by a single
+ * comparison. Lookups use (pointer, length) pairs to avoid any copy.
+ */
+class Names
+{
+public:
+  static const size_t npos = static_cast<size_t>(-1);
+
+private:
+  struct Entry
+  {
+    uint32_t hash;
+    size_t index;
+    std::string name;
+  };
+
+  std::vector<Entry> table;
+  size_t mask;
+
+  static uint32_t
+  hash(const char* s, size_t len)
+  {
+    // FNV-1a
+    uint32_t h = 2166136261u;
+    for(const char* e = s + len; s != e; ++s)
+      h = (h ^ static_cast<unsigned char>(*s)) * 16777619u;
+    return h;
+  }
+
+public:
+  explicit
+  Names(size_t capacity)
+  {
+    size_t size = 16;
+    while(size < capacity * 2) size <<= 1;
+
+    Entry empty;
+    empty.hash = 0;
+    empty.index = npos;
+    table.assign(size, empty);
+    mask = size - 1;
+  }
+
+
+  // insert a new name (the name must not be present already)
+  void
+  insert(const char* s, size_t len, size_t index)
+  {
+    uint32_t h = hash(s, len);
+    size_t i = h & mask;
+    while(table[i].index != npos)
+      i = (i + 1) & mask;
+
+    table[i].hash = h;
+    table[i].index = index;
+    table[i].name.assign(s, len);
+  }
+
+
+  size_t
+  find(const char* s, size_t len) const
+  {
+    uint32_t h = hash(s, len);
+    for(size_t i = h & mask;; i = (i + 1) & mask)
+    {
+      const Entry& e = table[i];
+      if(e.index == npos)
+	return npos;
+      if(e.hash == h && e.name.size() == len &&
+	  !memcmp(e.name.data(), s, len))
+	return e.index;
+    }
+  }
+};
+
+#endif
@@ -0,0 +1,182 @@
+/*
+ * offscreen: OpenGL rendering without a window, asynchronous readback
+ * Copyright(c) 2018 by wave++ "Yuri D'Elia" <wavexx@thregr.org>
+ * Distributed under GNU LGPL WITHOUT ANY WARRANTY.
+ */
+
+/*
+ * Headers
+ */
+
+// framebuffer objects are core in GL 3.0
+#define GL_GLEXT_PROTOTYPES
+
+// defaults
+#include "offscreen.hh"
+
+#ifdef HAVE_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+
+/*
+ * Offscreen
+ */
+
+Offscreen::Offscreen()
+: display(NULL), context(NULL), fbo(0), rbo(0)
+{}
+
+
+Offscreen::~Offscreen()
+{
+#ifdef HAVE_EGL
+  if(fbo) glDeleteFramebuffers(1, &fbo);
+  if(rbo) glDeleteRenderbuffers(1, &rbo);
+  if(context)
+  {
+    eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    eglDestroyContext(display, context);
+  }
+  if(display)
+    eglTerminate(display);
+#endif
+}
+
+
+bool
+Offscreen::open(int width, int height)
+{
+#ifdef HAVE_EGL
+  // prefer a display not bound to any window system
+  EGLDisplay dpy = EGL_NO_DISPLAY;
+  PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+    reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+      eglGetProcAddress("eglGetPlatformDisplayEXT"));
+#ifdef EGL_PLATFORM_SURFACELESS_MESA
+  if(getPlatformDisplay)
+    dpy = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA,
+	EGL_DEFAULT_DISPLAY, NULL);
+#endif
+  if(dpy == EGL_NO_DISPLAY)
+    dpy = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+  if(dpy == EGL_NO_DISPLAY || !eglInitialize(dpy, NULL, NULL))
+    return false;
+  display = dpy;
+
+  // a compatibility context without any surface (EGL_KHR_no_config_context)
+  if(!eglBindAPI(EGL_OPENGL_API))
+    return false;
+  EGLContext ctx = eglCreateContext(dpy, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT,
+      NULL);
+  if(ctx == EGL_NO_CONTEXT)
+    return false;
+  context = ctx;
+  if(!eglMakeCurrent(dpy, EGL_NO_SURFACE, EGL_NO_SURFACE, ctx))
+    return false;
+
+  // all the drawing goes into a single color buffer
+  glGenFramebuffers(1, &fbo);
+  glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+  glGenRenderbuffers(1, &rbo);
+  glBindRenderbuffer(GL_RENDERBUFFER, rbo);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+      GL_RENDERBUFFER, rbo);
+  if(glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    return false;
+
+  glViewport(0, 0, width, height);
+  return true;
+#else
+  return false;
+#endif
+}
+
+
+/*
+ * Readback
+ */
+
+Readback::Readback(int width, int height, size_t depth)
+: width(width), height(height), slots(depth), head(0), count(0)
+{
+  for(size_t i = 0; i != slots.size(); ++i)
+  {
+    Slot& s = slots[i];
+    glGenBuffers(1, &s.pbo);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, s.pbo);
+    glBufferData(GL_PIXEL_PACK_BUFFER, size(), NULL, GL_STREAM_READ);
+    s.fence = NULL;
+    s.tag = 0;
+  }
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+
+Readback::~Readback()
+{
+  for(size_t i = 0; i != slots.size(); ++i)
+  {
+    if(slots[i].fence)
+      glDeleteSync(static_cast<GLsync>(slots[i].fence));
+    glDeleteBuffers(1, &slots[i].pbo);
+  }
+}
+
+
+void
+Readback::start(uint64_t tag)
+{
+  Slot& s = slots[(head + count) % slots.size()];
+  s.tag = tag;
+  ++count;
+
+  // the transfer targets the bound buffer, and returns immediately
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, s.pbo);
+  glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, NULL);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  s.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  glFlush();
+}
+
+
+const unsigned char*
+Readback::map(bool wait, uint64_t& tag)
+{
+  if(!count)
+    return NULL;
+
+  Slot& s = slots[head];
+  GLsync fence = static_cast<GLsync>(s.fence);
+  GLenum r = glClientWaitSync(fence, 0, (wait? GL_TIMEOUT_IGNORED: 0));
+  if(r == GL_TIMEOUT_EXPIRED)
+    return NULL;
+  glDeleteSync(fence);
+  s.fence = NULL;
+
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, s.pbo);
+  const void* p = glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+  tag = s.tag;
+  if(!p)
+  {
+    // the frame is lost
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    head = (head + 1) % slots.size();
+    --count;
+  }
+
+  return static_cast<const unsigned char*>(p);
+}
+
+
+void
+Readback::unmap()
+{
+  glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  head = (head + 1) % slots.size();
+  --count;
+}
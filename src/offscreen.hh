@@ -0,0 +1,97 @@
+/*
+ * offscreen: OpenGL rendering without a window, asynchronous readback
+ * Copyright(c) 2018 by wave++ "Yuri D'Elia" <wavexx@thregr.org>
+ * Distributed under GNU LGPL WITHOUT ANY WARRANTY.
+ */
+
+#ifndef offscreen_hh
+#define offscreen_hh
+
+// GL headers
+#include "gl.hh"
+
+// system headers
+#include <vector>
+
+// c system headers
+#include <stddef.h>
+#include <stdint.h>
+
+
+/*
+ * A current GL context rendering into a framebuffer object, created on a
+ * "surfaceless" EGL display (Mesa's llvmpipe/softpipe work without a GPU or
+ * a display server). Only available when built with EGL (HAVE_EGL).
+ */
+class Offscreen
+{
+  void* display;
+  void* context;
+  GLuint fbo;
+  GLuint rbo;
+
+public:
+  Offscreen();
+  ~Offscreen();
+
+  // create the context and framebuffer (false on failure)
+  bool open(int width, int height);
+};
+
+
+/*
+ * Asynchronous readback of the color buffer (RGB, bottom row first) through a
+ * ring of pixel buffer objects: start() only queues the transfer, which is
+ * completed by the GL in the background, and map() returns the oldest frame
+ * once complete (each transfer is fenced), so that the frame loop is never
+ * stalled unless explicitly waiting.
+ */
+class Readback
+{
+  struct Slot
+  {
+    GLuint pbo;
+    void* fence;
+    uint64_t tag;
+  };
+
+  int width;
+  int height;
+  std::vector<Slot> slots;
+  size_t head;
+  size_t count;
+
+public:
+  Readback(int width, int height, size_t depth);
+  ~Readback();
+
+  // bytes per frame
+  size_t
+  size() const
+  {
+    return static_cast<size_t>(width) * height * 3;
+  }
+
+  bool
+  full() const
+  {
+    return count == slots.size();
+  }
+
+  bool
+  empty() const
+  {
+    return !count;
+  }
+
+  // queue the transfer of the current frame (the ring must not be full)
+  void start(uint64_t tag);
+
+  // map the oldest frame if complete (or after waiting), NULL otherwise
+  const unsigned char* map(bool wait, uint64_t& tag);
+
+  // release the frame returned by map()
+  void unmap();
+};
+
+#endif
@@ -0,0 +1,402 @@
+/*
+ * parser: incremental input stream parser
+ * Copyright(c) 2018 by wave++ "Yuri D'Elia" <wavexx@thregr.org>
+ * Distributed under GNU LGPL WITHOUT ANY WARRANTY.
+ */
+
+#ifndef parser_hh
+#define parser_hh
+
+// defaults
+#include "defaults.hh"
+
+// system headers
+#include <algorithm>
+#include <vector>
+
+// c system headers
+#include <stdlib.h>
+#include <string.h>
+
+
+/*
+ * The parser is fed with arbitrary chunks of a stream (as returned by a
+ * non-blocking read) and keeps any partial value internally until the rest of
+ * the value is received. Complete values are passed to out.value(double).
+ * Values fully contained in the chunk are converted in-place, so only values
+ * straddling two chunks are ever copied.
+ *
+ * Named input is line-based instead: each sample is passed along with the name
+ * of its series to out.named(name, len, double). Each line can be in
+ * key=value, InfluxDB line-protocol or statsd form.
+ *
+ * Garbage (unparsable or overlong values/lines) is skipped, calling
+ * out.error() for each occurrence.
+ */
+class Parser
+{
+  Trend::format_t format;
+  size_t len;
+  bool skip;
+  char buf[Trend::maxNumLen];
+  std::vector<char> line;
+  std::vector<char> tmp;
+
+  static bool
+  isSpc(const char c)
+  {
+    return (c == ' ' || (c >= '\t' && c <= '\r'));
+  }
+
+
+  // convert an ascii value, skipping garbage
+  template<class Out> static void
+  convert(const char* str, Out& out)
+  {
+    char* end;
+    double v = strtod(str, &end);
+    if(end != str) out.value(v);
+    else out.error();
+  }
+
+
+  template<class Out> void
+  feedAscii(const char* p, const char* end, Out& out)
+  {
+    const size_t maxLen = sizeof(buf) - 2;
+
+    // complete the pending value first
+    if(len || skip)
+    {
+      for(; p != end && !isSpc(*p); ++p)
+      {
+	if(len == maxLen) skip = true;
+	else buf[len++] = *p;
+      }
+      if(p == end) return;
+      if(!skip)
+      {
+	buf[len] = 0;
+	convert(buf, out);
+      }
+      else out.error();
+      len = 0;
+      skip = false;
+    }
+
+    for(;;)
+    {
+      while(p != end && isSpc(*p)) ++p;
+      if(p == end) return;
+
+      // strtod would stop on the separator in any case
+      const char* b = p;
+      while(p != end && !isSpc(*p)) ++p;
+      size_t n = p - b;
+      if(p == end)
+      {
+	// partial value
+	if(n > maxLen) skip = true;
+	else memcpy(buf, b, len = n);
+	return;
+      }
+      if(n <= maxLen) convert(b, out);
+      else out.error();
+    }
+  }
+
+
+  static const char*
+  find(const char* p, const char* end, const char c)
+  {
+    while(p != end && *p != c) ++p;
+    return p;
+  }
+
+
+  static const char*
+  token(const char* p, const char* end)
+  {
+    while(p != end && !isSpc(*p)) ++p;
+    return p;
+  }
+
+
+  // convert a whole token of a line (not terminated, and possibly at the end
+  // of the chunk) through a terminated copy
+  static bool
+  number(const char* b, const char* e, double& v)
+  {
+    const size_t n = e - b;
+    if(!n || n >= static_cast<size_t>(Trend::maxNumLen) || isSpc(*b))
+      return false;
+
+    char str[Trend::maxNumLen];
+    memcpy(str, b, n);
+    str[n] = 0;
+
+    char* end;
+    v = strtod(str, &end);
+    return (end == str + n);
+  }
+
+
+  // name:value|type[|@rate]
+  template<class Out> static void
+  parseStatsd(const char* b, const char* e, Out& out)
+  {
+    const char* bar = find(b, e, '|');
+    const char* colon = bar;
+    while(colon != b && *colon != ':') --colon;
+    if(colon == b)
+    {
+      out.error();
+      return;
+    }
+
+    double v;
+    if(!number(colon + 1, bar, v))
+    {
+      out.error();
+      return;
+    }
+
+    // scale sampled counters
+    if(bar + 1 != e && bar[1] == 'c')
+    {
+      const char* rate = find(bar + 1, e, '@');
+      double r;
+      if(rate != e && number(rate + 1, find(rate + 1, e, '|'), r) && r > 0)
+	v /= r;
+    }
+
+    out.named(b, colon - b, v);
+  }
+
+
+  // measurement[,tag=value...] field=value[,field=value...] [timestamp]
+  template<class Out> void
+  parseInflux(const char* b, const char* t, const char* e, Out& out)
+  {
+    const char* m = find(b, t, ',');
+    const size_t mLen = m - b;
+    memcpy(&tmp[0], b, mLen);
+    tmp[mLen] = '.';
+
+    while(t != e && isSpc(*t)) ++t;
+    const char* fe = token(t, e);
+
+    for(const char* f = t; f < fe; ++f)
+    {
+      const char* c = find(f, fe, ',');
+      const char* eq = find(f, c, '=');
+      if(eq == c) { f = c; continue; }
+
+      // strings and booleans are ignored (integers have an "i" suffix)
+      const char* ve = (c != eq + 1 && c[-1] == 'i'? c - 1: c);
+      double v;
+      if(number(eq + 1, ve, v))
+      {
+	size_t fLen = eq - f;
+	if(fLen == 5 && !memcmp(f, "value", 5))
+	  out.named(&tmp[0], mLen, v);
+	else
+	{
+	  memcpy(&tmp[mLen + 1], f, fLen);
+	  out.named(&tmp[0], mLen + 1 + fLen, v);
+	}
+      }
+
+      f = c;
+    }
+  }
+
+
+  // key=value[,key=value...] (or space separated)
+  template<class Out> static void
+  parseKeys(const char* b, const char* e, Out& out)
+  {
+    while(b < e)
+    {
+      while(b != e && (isSpc(*b) || *b == ',')) ++b;
+      const char* k = b;
+      while(b != e && !isSpc(*b) && *b != ',') ++b;
+
+      const char* eq = find(k, b, '=');
+      if(eq == k) continue;
+      if(eq == b)
+      {
+	out.error();
+	continue;
+      }
+
+      double v;
+      if(number(eq + 1, b, v)) out.named(k, eq - k, v);
+      else out.error();
+    }
+  }
+
+
+  template<class Out> void
+  parseLine(const char* b, const char* e, Out& out)
+  {
+    while(b != e && isSpc(*b)) ++b;
+    if(b == e || *b == '#') return;
+
+    // guess the format from the first token
+    const char* t = token(b, e);
+    const char* eq = find(b, t, '=');
+    const char* bar = find(b, t, '|');
+
+    if(bar != t && find(b, bar, ':') != bar)
+    {
+      for(; b != e; b = t)
+      {
+	t = token(b, e);
+	parseStatsd(b, t, out);
+	while(t != e && isSpc(*t)) ++t;
+      }
+    }
+    else if(eq == t || find(b, eq, ',') != eq)
+      parseInflux(b, t, e, out);
+    else
+      parseKeys(b, e, out);
+  }
+
+
+  template<class Out> void
+  feedNamed(const char* p, const char* end, Out& out)
+  {
+    const size_t maxLen = line.size() - 1;
+
+    // complete the pending line first
+    if(len || skip)
+    {
+      const char* nl = find(p, end, '\n');
+      size_t n = nl - p;
+      if(len + n > maxLen) skip = true;
+      else if(!skip)
+      {
+	memcpy(&line[len], p, n);
+	len += n;
+      }
+      if(nl == end) return;
+
+      if(!skip)
+      {
+	line[len] = 0;
+	parseLine(&line[0], &line[len], out);
+      }
+      else out.error();
+      len = 0;
+      skip = false;
+      p = nl + 1;
+    }
+
+    for(;;)
+    {
+      const char* nl = static_cast<const char*>(memchr(p, '\n', end - p));
+      if(!nl)
+      {
+	// partial line
+	size_t n = end - p;
+	if(n > maxLen) skip = true;
+	else memcpy(&line[0], p, len = n);
+	return;
+      }
+
+      parseLine(p, nl, out);
+      p = nl + 1;
+    }
+  }
+
+
+  template<class T, class Out> void
+  feedBinary(const char* p, const char* end, Out& out)
+  {
+    T v;
+
+    if(len)
+    {
+      size_t n = std::min(sizeof(T) - len, static_cast<size_t>(end - p));
+      memcpy(buf + len, p, n);
+      p += n;
+      if((len += n) != sizeof(T)) return;
+      memcpy(&v, buf, sizeof(T));
+      out.value(static_cast<double>(v));
+      len = 0;
+    }
+
+    for(; static_cast<size_t>(end - p) >= sizeof(T); p += sizeof(T))
+    {
+      memcpy(&v, p, sizeof(T));
+      out.value(static_cast<double>(v));
+    }
+
+    memcpy(buf, p, len = (end - p));
+  }
+
+
+public:
+  explicit
+  Parser(Trend::format_t format = Trend::format)
+  : format(format), len(0), skip(false)
+  {
+    if(format == Trend::f_named)
+    {
+      line.resize(Trend::maxLineLen + 1);
+      tmp.resize(Trend::maxLineLen * 2 + 1);
+    }
+  }
+
+
+  // discard any partial value
+  void
+  reset()
+  {
+    len = 0;
+    skip = false;
+  }
+
+
+  // feed a new chunk of the stream
+  template<class Out> void
+  feed(const char* p, const char* end, Out& out)
+  {
+    switch(format)
+    {
+    case Trend::f_ascii: feedAscii(p, end, out); break;
+    case Trend::f_float: feedBinary<float>(p, end, out); break;
+    case Trend::f_double: feedBinary<double>(p, end, out); break;
+    case Trend::f_short: feedBinary<short>(p, end, out); break;
+    case Trend::f_int: feedBinary<int>(p, end, out); break;
+    case Trend::f_long: feedBinary<long>(p, end, out); break;
+    case Trend::f_named: feedNamed(p, end, out); break;
+    }
+  }
+
+
+  // terminate the pending ascii value/line (as if a separator was received)
+  template<class Out> void
+  flush(Out& out)
+  {
+    if(skip)
+      out.error();
+    else if(len)
+    {
+      if(format == Trend::f_ascii)
+      {
+	buf[len] = 0;
+	convert(buf, out);
+      }
+      else if(format == Trend::f_named)
+      {
+	line[len] = 0;
+	parseLine(&line[0], &line[len], out);
+      }
+    }
+    reset();
+  }
+};
+
+#endif
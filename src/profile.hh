@@ -0,0 +1,187 @@
+/*
+ * profile: stage timing histograms
+ * Copyright(c) 2018 by wave++ "Yuri D'Elia" <wavexx@thregr.org>
+ * Distributed under GNU LGPL WITHOUT ANY WARRANTY.
+ */
+
+#ifndef profile_hh
+#define profile_hh
+
+// defaults
+#include "timer.hh"
+
+// c system headers
+#include <stdint.h>
+#include <string.h>
+
+
+/*
+ * Log-linear histogram of durations (ns), in the style of HDR histograms:
+ * each power of two is split into a fixed number of linear buckets, so that
+ * the relative error is bounded (~6%) over the whole range with a fixed
+ * memory footprint. Recording is lock-free (a single relaxed atomic add), and
+ * the counts can be taken by another thread at any time.
+ */
+class Histogram
+{
+public:
+  static const unsigned subBits = 4;
+  static const unsigned subCount = 1 << subBits;
+  static const unsigned buckets = (64 - subBits + 1) * subCount;
+
+private:
+  uint64_t counts[buckets];
+  uint64_t peak;
+
+  static unsigned
+  index(uint64_t v)
+  {
+    if(v < subCount) return v;
+    unsigned shift = (63 - __builtin_clzll(v)) - subBits;
+    return (shift + 1) * subCount + ((v >> shift) & (subCount - 1));
+  }
+
+  // highest value equivalent to the bucket
+  static uint64_t
+  value(unsigned i)
+  {
+    if(i < subCount) return i;
+    unsigned shift = i / subCount - 1;
+    uint64_t low = static_cast<uint64_t>(subCount + i % subCount) << shift;
+    return low + ((static_cast<uint64_t>(1) << shift) - 1);
+  }
+
+public:
+  // summary of the values taken
+  struct Summary
+  {
+    uint64_t count;
+    uint64_t p50;
+    uint64_t p99;
+    uint64_t max;
+  };
+
+  Histogram()
+  : peak(0)
+  {
+    memset(counts, 0, sizeof(counts));
+  }
+
+
+  void
+  record(uint64_t v)
+  {
+    __atomic_add_fetch(&counts[index(v)], 1, __ATOMIC_RELAXED);
+    if(v > __atomic_load_n(&peak, __ATOMIC_RELAXED))
+      __atomic_store_n(&peak, v, __ATOMIC_RELAXED);
+  }
+
+
+  // summarize and reset the values recorded so far
+  Summary
+  take()
+  {
+    uint64_t tmp[buckets];
+
+    Summary s;
+    s.count = 0;
+    for(unsigned i = 0; i != buckets; ++i)
+    {
+      tmp[i] = __atomic_exchange_n(&counts[i], 0, __ATOMIC_RELAXED);
+      s.count += tmp[i];
+    }
+    s.max = __atomic_exchange_n(&peak, 0, __ATOMIC_RELAXED);
+    s.p50 = s.p99 = 0;
+
+    const uint64_t r50 = (s.count + 1) / 2;
+    const uint64_t r99 = s.count - s.count / 100;
+    uint64_t cum = 0;
+    for(unsigned i = 0; i != buckets && cum < r99; ++i)
+    {
+      if(!tmp[i]) continue;
+      cum += tmp[i];
+      if(!s.p50 && cum >= r50) s.p50 = value(i);
+      if(cum >= r99) s.p99 = value(i);
+    }
+
+    // the bucket bound can exceed the real maximum
+    if(s.p50 > s.max) s.p50 = s.max;
+    if(s.p99 > s.max) s.p99 = s.max;
+    return s;
+  }
+};
+
+
+/*
+ * Per-stage timing of the producer and display threads. Timing is enabled
+ * globally: when disabled, start() returns 0 and nothing is recorded, so that
+ * the cost is a single load per stage.
+ */
+class Profile
+{
+public:
+  enum stage_t {s_parse, s_commit, s_copy, s_limits, s_clear, s_grid,
+    s_marks, s_fill, s_lines, s_distrib, s_text, s_swap, s_frame, stages};
+
+  static const char*
+  name(stage_t stage)
+  {
+    static const char* const names[stages] =
+    {
+      "parse", "commit", "copy", "limits", "clear", "grid", "marks", "fill",
+      "lines", "distrib", "text", "swap", "frame"
+    };
+    return names[stage];
+  }
+
+private:
+  bool on;
+  Histogram hist[stages];
+
+public:
+  Profile()
+  : on(false)
+  {}
+
+
+  void
+  enable(bool on)
+  {
+    __atomic_store_n(&this->on, on, __ATOMIC_RELAXED);
+  }
+
+
+  bool
+  enabled() const
+  {
+    return __atomic_load_n(&on, __ATOMIC_RELAXED);
+  }
+
+
+  // start timing a stage (0 when disabled)
+  uint64_t
+  start() const
+  {
+    return (enabled()? monotonic(): 0);
+  }
+
+
+  // record a stage started at "begin", returning the current time
+  uint64_t
+  lap(stage_t stage, uint64_t begin)
+  {
+    if(!begin) return 0;
+    uint64_t now = monotonic();
+    hist[stage].record(now - begin);
+    return now;
+  }
+
+
+  Histogram::Summary
+  take(stage_t stage)
+  {
+    return hist[stage].take();
+  }
+};
+
+#endif
@@ -0,0 +1,72 @@
+/*
+ * queue: bounded lock-free single-producer/single-consumer queue
+ * Copyright(c) 2018 by wave++ "Yuri D'Elia" <wavexx@thregr.org>
+ * Distributed under GNU LGPL WITHOUT ANY WARRANTY.
+ */
+
+#ifndef queue_hh
+#define queue_hh
+
+// system headers
+#include <vector>
+
+// c system headers
+#include <stddef.h>
+
+
+/*
+ * Fixed-size ring of pre-allocated elements. Exactly one thread may push and
+ * exactly one (other) thread may pop: each index is written by a single side
+ * only, so the only synchronisation needed is a release store of the own
+ * index and an acquire load of the other.
+ */
+template<class T> class Queue
+{
+  std::vector<T> buf;
+  size_t mask;
+
+  // keep the indexes on separate cache lines
+  size_t head __attribute__((aligned(64)));
+  size_t tail __attribute__((aligned(64)));
+
+public:
+  explicit
+  Queue(size_t capacity)
+  : head(0), tail(0)
+  {
+    size_t size = 1;
+    while(size < capacity) size <<= 1;
+    buf.resize(size);
+    mask = size - 1;
+  }
+
+
+  // producer side: return false when full
+  bool
+  push(const T& v)
+  {
+    size_t t = tail;
+    if(t - __atomic_load_n(&head, __ATOMIC_ACQUIRE) == buf.size())
+      return false;
+
+    buf[t & mask] = v;
+    __atomic_store_n(&tail, t + 1, __ATOMIC_RELEASE);
+    return true;
+  }
+
+
+  // consumer side: return false when empty
+  bool
+  pop(T& v)
+  {
+    size_t h = head;
+    if(h == __atomic_load_n(&tail, __ATOMIC_ACQUIRE))
+      return false;
+
+    v = buf[h & mask];
+    __atomic_store_n(&head, h + 1, __ATOMIC_RELEASE);
+    return true;
+  }
+};
+
+#endif
@@ -8,6 +8,9 @@
 #define rr_hh
 
 // system headers
+#include <limits>
+
+// c system headers
 #include <pthread.h>
 #include <string.h>
 
@@ -56,12 +59,34 @@ template<typename T>
     void
     push_back(const_reference value)
     {
+      // the position is published after the value (see last())
       pthread_mutex_lock(&mutex);
-      memcpy(data + pos++ % size, &value, sizeof(value_type));
+      const size_type p = pos;
+      memcpy(data + p % size, &value, sizeof(value_type));
+      __atomic_store_n(&pos, p + 1, __ATOMIC_RELEASE);
       pthread_mutex_unlock(&mutex);
     }
 
 
+    // number of values pushed so far (for the writer)
+    size_type
+    position() const
+    {
+      return pos;
+    }
+
+
+    // last value pushed (NaN while empty), without locking: the slot is
+    // overwritten only after another "size" values (for monitoring only)
+    value_type
+    last() const
+    {
+      const size_type p = __atomic_load_n(&pos, __ATOMIC_ACQUIRE);
+      if(!p) return std::numeric_limits<value_type>::quiet_NaN();
+      return data[(p - 1) % size];
+    }
+
+
     size_type
     copy(pointer buf)
     {
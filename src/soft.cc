@@ -0,0 +1,518 @@
+/*
+ * soft: software rasterizer
+ * Copyright(c) 2018 by wave++ "Yuri D'Elia" <wavexx@thregr.org>
+ * Distributed under GNU LGPL WITHOUT ANY WARRANTY.
+ */
+
+/*
+ * Headers
+ */
+
+// defaults
+#include "soft.hh"
+#include "font.hh"
+using std::string;
+
+// system headers
+#include <algorithm>
+
+// c system headers
+#include <math.h>
+
+
+/*
+ * Helpers
+ */
+
+namespace
+{
+  uint8_t
+  channel(float v)
+  {
+    return static_cast<uint8_t>(v <= 0.f? 0: (v >= 1.f? 255: v * 255.f + .5f));
+  }
+
+
+  // blend "s", premultiplied by alpha as 0xBB00RR and 0x00GG00 with 8 extra
+  // bits each, over "d" (ia = 256 - alpha)
+  inline uint32_t
+  blend(uint32_t d, uint32_t srb, uint32_t sg, uint32_t ia)
+  {
+    uint32_t rb = (((d & 0xff00ff) * ia + srb) >> 8) & 0xff00ff;
+    uint32_t g = (((d & 0x00ff00) * ia + sg) >> 8) & 0x00ff00;
+    return rb | g;
+  }
+
+
+  // first pixel whose center is at or after v, limited to [min, max]
+  int
+  first(double v, int min, int max)
+  {
+    v = ceil(v - .5);
+    return (v <= min? min: (v >= max? max: static_cast<int>(v)));
+  }
+
+
+  double
+  fpart(double v)
+  {
+    return v - floor(v);
+  }
+
+
+  // clip the segment to [lo, hi] (Liang-Barsky), false if outside
+  bool
+  clip(double& x0, double& y0, double& x1, double& y1, double loX,
+      double loY, double hiX, double hiY)
+  {
+    const double dx = x1 - x0;
+    const double dy = y1 - y0;
+    const double p[4] = {-dx, dx, -dy, dy};
+    const double q[4] = {x0 - loX, hiX - x0, y0 - loY, hiY - y0};
+    double t0 = 0.;
+    double t1 = 1.;
+
+    for(int i = 0; i != 4; ++i)
+    {
+      if(p[i] == 0.)
+      {
+	if(q[i] < 0.) return false;
+	continue;
+      }
+
+      double t = q[i] / p[i];
+      if(p[i] < 0.)
+      {
+	if(t > t1) return false;
+	if(t > t0) t0 = t;
+      }
+      else
+      {
+	if(t < t0) return false;
+	if(t < t1) t1 = t;
+      }
+    }
+
+    x1 = x0 + t1 * dx;
+    y1 = y0 + t1 * dy;
+    x0 += t0 * dx;
+    y0 += t0 * dy;
+    return true;
+  }
+}
+
+
+/*
+ * SoftTexture
+ */
+
+namespace
+{
+  struct SoftTexture: public Texture
+  {
+    int width;
+    int height;
+    std::vector<uint32_t> texels;
+
+    SoftTexture(int width, int height)
+    : width(width), height(height),
+      texels(static_cast<size_t>(width) * height)
+    {}
+
+    void
+    update(int x, int n, const uint32_t* src)
+    {
+      for(int y = 0; y != height; ++y)
+      {
+	const size_t row = static_cast<size_t>(y) * width + x;
+	std::copy(src + row, src + row + n, &texels[row]);
+      }
+    }
+  };
+}
+
+
+/*
+ * SoftDraw
+ */
+
+SoftDraw::SoftDraw()
+: width(0), height(0), vx0(0), vy0(0), vx1(0), vy1(0), back(0),
+  smooth(false), rgb(0), alpha(256), prim(p_lines)
+{
+  Transform t = {1., 0., -1., 0.};
+  xf = t;
+}
+
+
+void
+SoftDraw::init(const float* back, bool smooth)
+{
+  this->back = (channel(back[0]) | channel(back[1]) << 8 |
+      channel(back[2]) << 16);
+  this->smooth = smooth;
+}
+
+
+void
+SoftDraw::resize(int width, int height)
+{
+  this->width = width;
+  this->height = height;
+  pixels.resize(static_cast<size_t>(width) * height);
+  viewport(0, 0, width, height);
+}
+
+
+void
+SoftDraw::viewport(int x, int y, int width, int height)
+{
+  // clipped to the framebuffer
+  vx0 = std::max(x, 0);
+  vx1 = std::min(x + width, this->width);
+  vy0 = std::max(this->height - (y + height), 0);
+  vy1 = std::min(this->height - y, this->height);
+  if(vx1 < vx0) vx1 = vx0;
+  if(vy1 < vy0) vy1 = vy0;
+}
+
+
+void
+SoftDraw::clear()
+{
+  for(int y = vy0; y < vy1; ++y)
+    span(y, vx0, vx1, back, 256);
+}
+
+
+void
+SoftDraw::ortho(double left, double right, double bottom, double top)
+{
+  // y is flipped, as framebuffer rows are stored top to bottom
+  xf.sx = (vx1 - vx0) / (right - left);
+  xf.tx = vx0 - left * xf.sx;
+  xf.sy = -(vy1 - vy0) / (top - bottom);
+  xf.ty = vy1 - bottom * xf.sy;
+}
+
+
+void
+SoftDraw::push()
+{
+  saved.push_back(xf);
+}
+
+
+void
+SoftDraw::pop()
+{
+  xf = saved.back();
+  saved.pop_back();
+}
+
+
+void
+SoftDraw::color(float r, float g, float b, float a)
+{
+  rgb = (channel(r) | channel(g) << 8 | channel(b) << 16);
+  alpha = (a <= 0.f? 0: (a >= 1.f? 256: static_cast<int>(a * 256.f + .5f)));
+}
+
+
+void
+SoftDraw::begin(prim_t prim)
+{
+  this->prim = prim;
+  verts.clear();
+}
+
+
+void
+SoftDraw::vertex(double x, double y)
+{
+  Vertex v = {x * xf.sx + xf.tx, y * xf.sy + xf.ty, rgb, alpha};
+  verts.push_back(v);
+}
+
+
+void
+SoftDraw::end()
+{
+  const size_t n = verts.size();
+  switch(prim)
+  {
+  case p_lines:
+    for(size_t i = 1; i < n; i += 2)
+      line(verts[i - 1], verts[i]);
+    break;
+
+  case p_lineStrip:
+  case p_lineLoop:
+    for(size_t i = 1; i < n; ++i)
+      line(verts[i - 1], verts[i]);
+    if(prim == p_lineLoop && n > 2)
+      line(verts[n - 1], verts[0]);
+    break;
+
+  case p_quads:
+    for(size_t i = 3; i < n; i += 4)
+    {
+      triangle(verts[i - 3], verts[i - 2], verts[i - 1]);
+      triangle(verts[i - 3], verts[i - 1], verts[i]);
+    }
+    break;
+
+  case p_quadStrip:
+    for(size_t i = 3; i < n; i += 2)
+    {
+      triangle(verts[i - 3], verts[i - 2], verts[i]);
+      triangle(verts[i - 3], verts[i], verts[i - 1]);
+    }
+    break;
+  }
+
+  verts.clear();
+}
+
+
+void
+SoftDraw::plot(int x, int y, uint32_t rgb, int alpha)
+{
+  if(x < vx0 || x >= vx1 || y < vy0 || y >= vy1 || alpha <= 0)
+    return;
+
+  uint32_t& d = pixels[static_cast<size_t>(y) * width + x];
+  if(alpha >= 256)
+    d = rgb;
+  else
+    d = blend(d, (rgb & 0xff00ff) * alpha, (rgb & 0x00ff00) * alpha,
+	256 - alpha);
+}
+
+
+// fill [x0, x1) of row y: the blending loop has no dependencies between
+// pixels and handles two channels per multiplication, so that it can be
+// vectorized by the compiler as well
+void
+SoftDraw::span(int y, int x0, int x1, uint32_t rgb, int alpha)
+{
+  if(x0 >= x1 || alpha <= 0) return;
+
+  uint32_t* p = &pixels[static_cast<size_t>(y) * width + x0];
+  uint32_t* e = p + (x1 - x0);
+  if(alpha >= 256)
+  {
+    std::fill(p, e, rgb);
+    return;
+  }
+
+  const uint32_t srb = (rgb & 0xff00ff) * alpha;
+  const uint32_t sg = (rgb & 0x00ff00) * alpha;
+  const uint32_t ia = 256 - alpha;
+  for(; p != e; ++p)
+    *p = blend(*p, srb, sg, ia);
+}
+
+
+void
+SoftDraw::line(const Vertex& a, const Vertex& b)
+{
+  // move to pixel centers and drop what can't be seen (or is undefined)
+  double x0 = a.x - .5, y0 = a.y - .5;
+  double x1 = b.x - .5, y1 = b.y - .5;
+  if(!isfinite(x0) || !isfinite(y0) || !isfinite(x1) || !isfinite(y1) ||
+      !clip(x0, y0, x1, y1, vx0 - 1., vy0 - 1., vx1, vy1))
+    return;
+
+  if(smooth)
+  {
+    lineWu(x0, y0, x1, y1, b.rgb, b.alpha);
+    return;
+  }
+
+  // DDA, excluding the last pixel so that strips don't blend it twice
+  const double dx = x1 - x0;
+  const double dy = y1 - y0;
+  const int n = static_cast<int>(std::max(fabs(dx), fabs(dy)) + .5);
+  if(!n)
+  {
+    plot(static_cast<int>(floor(x0 + .5)), static_cast<int>(floor(y0 + .5)),
+	b.rgb, b.alpha);
+    return;
+  }
+
+  const double ix = dx / n;
+  const double iy = dy / n;
+  for(int i = 0; i != n; ++i, x0 += ix, y0 += iy)
+    plot(static_cast<int>(floor(x0 + .5)), static_cast<int>(floor(y0 + .5)),
+	b.rgb, b.alpha);
+}
+
+
+void
+SoftDraw::lineWu(double x0, double y0, double x1, double y1, uint32_t rgb,
+    int alpha)
+{
+  // walk the major axis as x
+  const bool steep = (fabs(y1 - y0) > fabs(x1 - x0));
+  if(steep)
+  {
+    std::swap(x0, y0);
+    std::swap(x1, y1);
+  }
+  if(x0 > x1)
+  {
+    std::swap(x0, x1);
+    std::swap(y0, y1);
+  }
+
+  const double dx = x1 - x0;
+  const double grad = (dx == 0.? 1.: (y1 - y0) / dx);
+
+  // each column covers two pixels, weighted by the distance to the line
+  // (and by the horizontal coverage at the end points)
+  const int xs = static_cast<int>(floor(x0 + .5));
+  const int xe = static_cast<int>(floor(x1 + .5));
+  double y = y0 + grad * (xs - x0);
+  for(int x = xs; x <= xe; ++x, y += grad)
+  {
+    double cov = 1.;
+    if(x == xs) cov = 1. - fpart(x0 + .5);
+    if(x == xe) cov = (xs == xe? x1 - x0: fpart(x1 + .5));
+
+    const int yi = static_cast<int>(floor(y));
+    const double f = fpart(y);
+    const int a0 = static_cast<int>(alpha * cov * (1. - f) + .5);
+    const int a1 = static_cast<int>(alpha * cov * f + .5);
+    if(steep)
+    {
+      plot(yi, x, rgb, a0);
+      plot(yi + 1, x, rgb, a1);
+    }
+    else
+    {
+      plot(x, yi, rgb, a0);
+      plot(x, yi + 1, rgb, a1);
+    }
+  }
+}
+
+
+// fill the pixels whose centers are inside the triangle: the edges are
+// evaluated the same way whatever their direction, and spans are half-open,
+// so that triangles sharing an edge don't overlap
+void
+SoftDraw::triangle(const Vertex& a, const Vertex& b, const Vertex& c)
+{
+  const Vertex* v[3] = {&a, &b, &c};
+  for(int i = 0; i != 3; ++i)
+    if(!isfinite(v[i]->x) || !isfinite(v[i]->y))
+      return;
+
+  // sort by y
+  if(v[0]->y > v[1]->y) std::swap(v[0], v[1]);
+  if(v[1]->y > v[2]->y) std::swap(v[1], v[2]);
+  if(v[0]->y > v[1]->y) std::swap(v[0], v[1]);
+
+  const int y0 = first(v[0]->y, vy0, vy1);
+  const int y1 = first(v[2]->y, vy0, vy1);
+  for(int y = y0; y < y1; ++y)
+  {
+    const double yc = y + .5;
+
+    // the long edge, and the short one spanning this row
+    const Vertex* e0 = v[0];
+    const Vertex* e1 = (yc < v[1]->y? v[0]: v[1]);
+    const Vertex* f1 = (yc < v[1]->y? v[1]: v[2]);
+    double l = e0->x + (yc - e0->y) * (v[2]->x - e0->x) / (v[2]->y - e0->y);
+    double r = e1->x + (yc - e1->y) * (f1->x - e1->x) / (f1->y - e1->y);
+    if(l > r) std::swap(l, r);
+
+    span(y, first(l, vx0, vx1), first(r, vx0, vx1), c.rgb, c.alpha);
+  }
+}
+
+
+void
+SoftDraw::text(int x, int y, const string& str)
+{
+  // viewport coordinates: the bottom row of the glyphs is fontBase pixels
+  // below the baseline
+  const int top = vy1 - 1 - (y - Trend::fontBase);
+  x += vx0;
+  for(string::const_iterator p = str.begin(); p != str.end();
+      ++p, x += Trend::fontCellW)
+  {
+    const unsigned char* glyph = Trend::font8x13[static_cast<unsigned char>(*p)];
+    for(int r = 0; r != Trend::fontCellH; ++r)
+    {
+      if(!glyph[r]) continue;
+      for(int i = 0; i != Trend::fontCellW; ++i)
+	if(glyph[r] & (0x80 >> i))
+	  plot(x + i, top - r, rgb, alpha);
+    }
+  }
+}
+
+
+Texture*
+SoftDraw::texture(int width, int height)
+{
+  return new SoftTexture(width, height);
+}
+
+
+// nearest texel of each pixel whose center is inside the rectangle
+void
+SoftDraw::blit(Texture* tex, double s0, double s1, double x0, double y0,
+    double x1, double y1)
+{
+  const SoftTexture* t = static_cast<const SoftTexture*>(tex);
+  double px0 = x0 * xf.sx + xf.tx, px1 = x1 * xf.sx + xf.tx;
+  double py0 = y0 * xf.sy + xf.ty, py1 = y1 * xf.sy + xf.ty;
+  if(!isfinite(px0) || !isfinite(px1) || !isfinite(py0) || !isfinite(py1) ||
+      px0 == px1 || py0 == py1 || !t->width || !t->height)
+    return;
+
+  // texel coordinates at the pixel centers (row 0 is at y0)
+  const double ds = (s1 - s0) / (px1 - px0);
+  const double dt = t->height / (py1 - py0);
+  const double ox = px0, oy = py0;
+  if(px0 > px1) std::swap(px0, px1);
+  if(py0 > py1) std::swap(py0, py1);
+
+  const int cx0 = first(px0, vx0, vx1), cx1 = first(px1, vx0, vx1);
+  const int cy0 = first(py0, vy0, vy1), cy1 = first(py1, vy0, vy1);
+  for(int y = cy0; y < cy1; ++y)
+  {
+    int r = static_cast<int>(floor((y + .5 - oy) * dt));
+    r = std::min(std::max(r, 0), t->height - 1);
+
+    const uint32_t* row = &t->texels[static_cast<size_t>(r) * t->width];
+    for(int x = cx0; x < cx1; ++x)
+    {
+      int c = static_cast<int>(floor(s0 + (x + .5 - ox) * ds));
+      c = std::min(std::max(c, 0), t->width - 1);
+
+      const uint32_t texel = row[c];
+      const int a = (texel >> 24) + (texel >> 31);
+      plot(x, y, texel & 0xffffff, a);
+    }
+  }
+}
+
+
+void
+SoftDraw::read(unsigned char* out) const
+{
+  for(int y = height; y--;)
+  {
+    const uint32_t* p = &pixels[static_cast<size_t>(y) * width];
+    for(int x = 0; x != width; ++x, ++p)
+    {
+      *out++ = (*p & 0xff);
+      *out++ = ((*p >> 8) & 0xff);
+      *out++ = ((*p >> 16) & 0xff);
+    }
+  }
+}
@@ -0,0 +1,100 @@
+/*
+ * soft: software rasterizer
+ * Copyright(c) 2018 by wave++ "Yuri D'Elia" <wavexx@thregr.org>
+ * Distributed under GNU LGPL WITHOUT ANY WARRANTY.
+ */
+
+#ifndef soft_hh
+#define soft_hh
+
+// defaults
+#include "draw.hh"
+
+// system headers
+#include <string>
+#include <vector>
+
+// c system headers
+#include <stdint.h>
+
+
+/*
+ * Drawing into a memory framebuffer, without any GL. Quads are split into
+ * triangles and filled by spans (alpha blended two channels at a time), lines
+ * are single pixels wide (Xiaolin Wu's antialiased lines when smoothing).
+ * Colors are not interpolated: each primitive takes the color of its last
+ * vertex (like flat shading).
+ */
+class SoftDraw: public Draw
+{
+  struct Vertex
+  {
+    double x;
+    double y;		// framebuffer coordinates (origin top-left)
+    uint32_t rgb;	// 0xBBGGRR
+    int alpha;		// 0-256
+  };
+
+  struct Transform
+  {
+    double sx, tx;
+    double sy, ty;
+  };
+
+  int width;
+  int height;
+  std::vector<uint32_t> pixels;
+
+  // viewport (origin top-left)
+  int vx0, vy0;
+  int vx1, vy1;
+
+  uint32_t back;
+  bool smooth;
+  Transform xf;
+  std::vector<Transform> saved;
+  uint32_t rgb;
+  int alpha;
+  prim_t prim;
+  std::vector<Vertex> verts;
+
+  void plot(int x, int y, uint32_t rgb, int alpha);
+  void span(int y, int x0, int x1, uint32_t rgb, int alpha);
+  void line(const Vertex& a, const Vertex& b);
+  void lineWu(double x0, double y0, double x1, double y1, uint32_t rgb,
+      int alpha);
+  void triangle(const Vertex& a, const Vertex& b, const Vertex& c);
+
+public:
+  SoftDraw();
+
+  void init(const float* back, bool smooth);
+  void resize(int width, int height);
+  void viewport(int x, int y, int width, int height);
+  void clear();
+  void ortho(double left, double right, double bottom, double top);
+  void push();
+  void pop();
+  void color(float r, float g, float b, float a = 1.f);
+  using Draw::color;
+  void begin(prim_t prim);
+  void vertex(double x, double y);
+  void end();
+  void text(int x, int y, const std::string& str);
+  Texture* texture(int width, int height);
+  void blit(Texture* tex, double s0, double s1, double x0, double y0,
+      double x1, double y1);
+  void finish(bool wait) {}
+
+  // bytes of an RGB copy of the framebuffer
+  size_t
+  size() const
+  {
+    return static_cast<size_t>(width) * height * 3;
+  }
+
+  // copy the framebuffer as RGB, bottom row first (as read back from GL)
+  void read(unsigned char* rgb) const;
+};
+
+#endif
@@ -0,0 +1,324 @@
+/*
+ * spectrum: windowed FFT of the last values of a graph - implementation
+ * Copyright(c) 2018 by wave++ "Yuri D'Elia" <wavexx@thregr.org>
+ * Distributed under GNU LGPL WITHOUT ANY WARRANTY.
+ */
+
+/*
+ * Headers
+ */
+
+// interface
+#include "spectrum.hh"
+using std::vector;
+
+// system headers
+#include <algorithm>
+
+// c system headers
+#include <math.h>
+
+
+/*
+ * Implementation
+ */
+
+namespace
+{
+  // power below the floor is shown at the floor (-200dB)
+  const float minPower = 1e-20f;
+
+  inline float
+  decibel(float power)
+  {
+    return 10.f * log10f(power > minPower? power: minPower);
+  }
+}
+
+
+FFT::FFT(size_t size)
+: n(size), half(size / 2), win(size), twr(half - 1), twi(half - 1),
+  spr(half + 1), spi(half + 1), rev(half), re(half), im(half)
+{
+  // periodic Hann window
+  for(size_t i = 0; i != n; ++i)
+    win[i] = .5 - .5 * cos(2. * M_PI * i / n);
+
+  // exp(-i pi j / m) for each pass of half-size m, stored at m - 1
+  for(size_t m = 1; m < half; m *= 2)
+    for(size_t j = 0; j != m; ++j)
+    {
+      twr[m - 1 + j] = cos(M_PI * j / m);
+      twi[m - 1 + j] = -sin(M_PI * j / m);
+    }
+
+  // exp(i 2 pi k / n), to split the transform of the packed real values
+  for(size_t k = 0; k <= half; ++k)
+  {
+    spr[k] = cos(2. * M_PI * k / n);
+    spi[k] = sin(2. * M_PI * k / n);
+  }
+
+  size_t bits = 0;
+  while((static_cast<size_t>(1) << bits) < half) ++bits;
+  for(size_t i = 0; i != half; ++i)
+  {
+    uint32_t r = 0;
+    for(size_t b = 0; b != bits; ++b)
+      r |= ((i >> b) & 1) << (bits - 1 - b);
+    rev[i] = r;
+  }
+}
+
+
+void
+FFT::power(const float* in, float* power)
+{
+  // even/odd values packed as complex, in bit-reversed order
+  for(size_t i = 0; i != half; ++i)
+  {
+    re[rev[i]] = in[2 * i] * win[2 * i];
+    im[rev[i]] = in[2 * i + 1] * win[2 * i + 1];
+  }
+
+  // decimation in time
+  for(size_t m = 1; m < half; m *= 2)
+  {
+    const float* wr = &twr[m - 1];
+    const float* wi = &twi[m - 1];
+    for(size_t k = 0; k < half; k += 2 * m)
+    {
+      float* ar = &re[k];
+      float* ai = &im[k];
+      float* br = ar + m;
+      float* bi = ai + m;
+      for(size_t j = 0; j != m; ++j)
+      {
+	const float tr = br[j] * wr[j] - bi[j] * wi[j];
+	const float ti = br[j] * wi[j] + bi[j] * wr[j];
+	br[j] = ar[j] - tr;
+	bi[j] = ai[j] - ti;
+	ar[j] += tr;
+	ai[j] += ti;
+      }
+    }
+  }
+
+  // split into the spectrum of the real values: with E and O the transforms
+  // of the even and odd values, X[k] = E[k] + exp(-i 2 pi k / n) O[k]
+  const float scale = 16.f / (static_cast<float>(n) * n);
+  const float dc = re[0] + im[0];
+  const float nyq = re[0] - im[0];
+  power[0] = dc * dc * scale / 4;
+  power[half] = nyq * nyq * scale / 4;
+  for(size_t k = 1; k != half; ++k)
+  {
+    const float a = re[k], b = im[k];
+    const float c = re[half - k], d = im[half - k];
+    const float er = (a + c) * .5f, ei = (b - d) * .5f;
+    const float orr = (b + d) * .5f, oi = (c - a) * .5f;
+    const float xr = er + spr[k] * orr + spi[k] * oi;
+    const float xi = ei + spr[k] * oi - spi[k] * orr;
+    power[k] = (xr * xr + xi * xi) * scale;
+  }
+}
+
+
+Spectrum::Spectrum(size_t size, size_t average, size_t backlog)
+: fft(size), hop(std::max(size / 4, static_cast<size_t>(1))),
+  average(std::max(average, static_cast<size_t>(1))), inPos(0), fed(0),
+  fresh(true), started(false), stop(false), busy(false),
+  frameEnd(0), frames(0), epoch(0), avg(fft.bins()), peak(fft.bins()),
+  serial(0), seen(0)
+{
+  // a power of 2, for masking
+  size_t len = size * 2;
+  while(len < size + backlog) len *= 2;
+  ring.resize(len);
+
+  pthread_mutex_init(&mutex, NULL);
+  pthread_cond_init(&wake, NULL);
+  pthread_cond_init(&idle, NULL);
+}
+
+
+Spectrum::~Spectrum()
+{
+  if(started)
+  {
+    pthread_mutex_lock(&mutex);
+    stop = true;
+    pthread_cond_signal(&wake);
+    pthread_mutex_unlock(&mutex);
+    pthread_join(thread, NULL);
+  }
+
+  pthread_cond_destroy(&idle);
+  pthread_cond_destroy(&wake);
+  pthread_mutex_destroy(&mutex);
+}
+
+
+bool
+Spectrum::open()
+{
+  if(pthread_create(&thread, NULL, run, this))
+    return false;
+
+  started = true;
+  return true;
+}
+
+
+void
+Spectrum::feed(const double* end, size_t pos, size_t avail)
+{
+  // older values would be overwritten in the ring anyway
+  size_t len = (fresh || pos < fed? avail: std::min(pos - fed, avail));
+  len = std::min(len, ring.size());
+  fed = pos;
+  fresh = false;
+  if(!len) return;
+
+  const size_t mask = ring.size() - 1;
+  pthread_mutex_lock(&mutex);
+  for(const double* it = end - len; it != end; ++it)
+    ring[inPos++ & mask] = (isfinite(*it)? *it: 0.f);
+  pthread_cond_signal(&wake);
+  pthread_mutex_unlock(&mutex);
+}
+
+
+void
+Spectrum::reset()
+{
+  pthread_mutex_lock(&mutex);
+  inPos = frameEnd = frames = 0;
+  ++epoch;
+  std::fill(avg.begin(), avg.end(), 0.f);
+  std::fill(peak.begin(), peak.end(), 0.f);
+  outAvg.clear();
+  outPeak.clear();
+  ++serial;
+  pthread_mutex_unlock(&mutex);
+  fresh = true;
+}
+
+
+void
+Spectrum::resetPeaks()
+{
+  pthread_mutex_lock(&mutex);
+  peak = avg;
+  if(frames)
+  {
+    for(size_t i = 0; i != peak.size(); ++i)
+      outPeak[i] = decibel(peak[i]);
+    ++serial;
+  }
+  pthread_mutex_unlock(&mutex);
+}
+
+
+bool
+Spectrum::fetch(vector<float>& avg, vector<float>& peak)
+{
+  pthread_mutex_lock(&mutex);
+  const bool updated = (serial != seen);
+  if(updated)
+  {
+    avg = outAvg;
+    peak = outPeak;
+    seen = serial;
+  }
+  pthread_mutex_unlock(&mutex);
+  return updated;
+}
+
+
+void
+Spectrum::sync()
+{
+  size_t end;
+  pthread_mutex_lock(&mutex);
+  while(busy || next(end))
+    pthread_cond_wait(&idle, &mutex);
+  pthread_mutex_unlock(&mutex);
+}
+
+
+// end of the next frame to analyze, if any (with the mutex held)
+bool
+Spectrum::next(size_t& end)
+{
+  const size_t n = fft.size();
+  if(inPos < n) return false;
+
+  // frames end at multiples of the hop, the latest if already overwritten
+  end = std::max(frameEnd + hop, n);
+  if(end > inPos) return false;
+  if(inPos - (end - n) > ring.size())
+    end = inPos - inPos % hop;
+
+  return true;
+}
+
+
+void*
+Spectrum::run(void* arg)
+{
+  static_cast<Spectrum*>(arg)->work();
+  return NULL;
+}
+
+
+void
+Spectrum::work()
+{
+  const size_t n = fft.size();
+  const size_t mask = ring.size() - 1;
+  vector<float> frame(n);
+  vector<float> power(fft.bins());
+
+  pthread_mutex_lock(&mutex);
+  while(!stop)
+  {
+    size_t end;
+    if(!next(end))
+    {
+      busy = false;
+      pthread_cond_broadcast(&idle);
+      pthread_cond_wait(&wake, &mutex);
+      continue;
+    }
+
+    // the transform runs unlocked, and is discarded after a reset
+    busy = true;
+    for(size_t i = 0; i != n; ++i)
+      frame[i] = ring[(end - n + i) & mask];
+    frameEnd = end;
+    const uint64_t frameEpoch = epoch;
+    pthread_mutex_unlock(&mutex);
+
+    fft.power(&frame[0], &power[0]);
+
+    pthread_mutex_lock(&mutex);
+    if(frameEpoch != epoch) continue;
+
+    // the mean of the frames so far, until "average" are available
+    const float k = 1.f / std::min(++frames, average);
+    outAvg.resize(power.size());
+    outPeak.resize(power.size());
+    for(size_t i = 0; i != power.size(); ++i)
+    {
+      avg[i] += (power[i] - avg[i]) * k;
+      if(power[i] > peak[i]) peak[i] = power[i];
+      outAvg[i] = decibel(avg[i]);
+      outPeak[i] = decibel(peak[i]);
+    }
+    ++serial;
+  }
+  busy = false;
+  pthread_cond_broadcast(&idle);
+  pthread_mutex_unlock(&mutex);
+}
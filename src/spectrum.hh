@@ -0,0 +1,120 @@
+/*
+ * spectrum: windowed FFT of the last values of a graph
+ * Copyright(c) 2018 by wave++ "Yuri D'Elia" <wavexx@thregr.org>
+ * Distributed under GNU LGPL WITHOUT ANY WARRANTY.
+ */
+
+#ifndef spectrum_hh
+#define spectrum_hh
+
+// system headers
+#include <vector>
+
+// c system headers
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+
+
+/*
+ * Power spectrum of "size" real values (a power of 2, at least 4), as a
+ * complex radix-2 FFT of half the size followed by the real split. The data
+ * is kept in separate real/imaginary arrays and the twiddles of each pass are
+ * contiguous, so that the butterflies run over unit-stride arrays (which the
+ * compiler can vectorize) without any platform-specific code.
+ */
+class FFT
+{
+  size_t n;
+  size_t half;
+  std::vector<float> win;
+  std::vector<float> twr, twi;	// twiddles of all the passes
+  std::vector<float> spr, spi;	// twiddles of the real split
+  std::vector<uint32_t> rev;	// bit-reversed order
+  std::vector<float> re, im;
+
+public:
+  explicit FFT(size_t size);
+
+  size_t size() const { return n; }
+  size_t bins() const { return half + 1; }
+
+  // Hann-windowed power of each bin, scaled so that a sinusoid of amplitude 1
+  // centered on a bin gives 1 (power receives bins() values)
+  void power(const float* in, float* power);
+};
+
+
+/*
+ * The spectrum of a graph, updated by a worker thread. Values are fed from the
+ * GL thread (only the ones not seen yet are copied), and a new FFT frame is
+ * computed every size/4 values (frames overlap by 75%). Up to "backlog" values
+ * are queued besides the current frame: when the worker falls further behind,
+ * the frames in between are skipped. The power is averaged over the
+ * last "average" frames (exponentially, once that many are available) and
+ * the maximum of each bin is held until reset. The GL thread never waits for
+ * the worker, except on request through sync().
+ */
+class Spectrum
+{
+  FFT fft;
+  size_t hop;
+  size_t average;
+
+  // input ring (counts since the last reset)
+  std::vector<float> ring;
+  size_t inPos;
+  size_t fed;
+  bool fresh;
+
+  // worker state
+  pthread_t thread;
+  pthread_mutex_t mutex;
+  pthread_cond_t wake;
+  pthread_cond_t idle;
+  bool started;
+  bool stop;
+  bool busy;
+  size_t frameEnd;
+  size_t frames;
+  uint64_t epoch;
+  std::vector<float> avg;
+  std::vector<float> peak;
+
+  // results (dB)
+  std::vector<float> outAvg;
+  std::vector<float> outPeak;
+  uint64_t serial;
+  uint64_t seen;
+
+  static void* run(void* arg);
+  void work();
+  bool next(size_t& end);
+
+public:
+  Spectrum(size_t size, size_t average, size_t backlog);
+  ~Spectrum();
+
+  bool open();
+
+  size_t size() const { return fft.size(); }
+  size_t bins() const { return fft.bins(); }
+
+  // values up to count "pos", the last at end[-1] and "avail" of them at most
+  void feed(const double* end, size_t pos, size_t avail);
+
+  // forget the values, the average and the peaks (for a different graph)
+  void reset();
+
+  // restart the peaks from the average
+  void resetPeaks();
+
+  // copy the last average and peak power (dB, empty before the first
+  // frame), false if unchanged
+  bool fetch(std::vector<float>& avg, std::vector<float>& peak);
+
+  // wait for the values fed so far to be analyzed (for lockstep rendering)
+  void sync();
+};
+
+#endif
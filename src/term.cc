@@ -0,0 +1,183 @@
+/*
+ * term: text-mode canvas for terminals - implementation
+ * Copyright(c) 2018 by wave++ "Yuri D'Elia" <wavexx@thregr.org>
+ * Distributed under GNU LGPL WITHOUT ANY WARRANTY.
+ */
+
+/*
+ * Headers
+ */
+
+// interface
+#include "term.hh"
+using std::string;
+
+// system headers
+#include <algorithm>
+
+// c system headers
+#include <stdio.h>
+#include <stdlib.h>
+
+
+/*
+ * Implementation
+ */
+
+namespace
+{
+  void
+  putUTF8(string& out, uint32_t c)
+  {
+    if(c < 0x80)
+      out += static_cast<char>(c);
+    else if(c < 0x800)
+    {
+      out += static_cast<char>(0xC0 | (c >> 6));
+      out += static_cast<char>(0x80 | (c & 0x3F));
+    }
+    else
+    {
+      out += static_cast<char>(0xE0 | (c >> 12));
+      out += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+      out += static_cast<char>(0x80 | (c & 0x3F));
+    }
+  }
+}
+
+
+Canvas::Canvas(style_t style)
+: style(style), cols(0), rows(0), dw(2), dh(style == s_braille? 4: 2),
+  full(true)
+{}
+
+
+void
+Canvas::resize(int cols, int rows)
+{
+  this->cols = cols;
+  this->rows = rows;
+  bits.assign(static_cast<size_t>(cols) * rows, 0);
+  cells.resize(bits.size());
+  shown.resize(bits.size());
+  full = true;
+}
+
+
+void
+Canvas::clear()
+{
+  std::fill(bits.begin(), bits.end(), 0);
+  for(std::vector<Cell>::iterator it = cells.begin(); it != cells.end(); ++it)
+  {
+    it->ch = 0;
+    it->rgb = 0;
+  }
+}
+
+
+void
+Canvas::line(int x0, int y0, int x1, int y1, uint32_t rgb)
+{
+  // Bresenham
+  const int dx = abs(x1 - x0);
+  const int dy = -abs(y1 - y0);
+  const int sx = (x0 < x1? 1: -1);
+  const int sy = (y0 < y1? 1: -1);
+  int err = dx + dy;
+
+  for(;;)
+  {
+    dot(x0, y0, rgb);
+    if(x0 == x1 && y0 == y1) break;
+
+    int e2 = 2 * err;
+    if(e2 >= dy)
+    {
+      err += dy;
+      x0 += sx;
+    }
+    if(e2 <= dx)
+    {
+      err += dx;
+      y0 += sy;
+    }
+  }
+}
+
+
+void
+Canvas::text(int col, int row, const string& str, uint32_t rgb)
+{
+  if(row < 0 || row >= rows)
+    return;
+
+  for(string::const_iterator it = str.begin();
+      it != str.end() && col < cols; ++it, ++col)
+  {
+    if(col < 0) continue;
+    Cell& c = cells[static_cast<size_t>(row) * cols + col];
+    c.ch = static_cast<unsigned char>(*it);
+    c.rgb = rgb;
+  }
+}
+
+
+uint32_t
+Canvas::glyph(unsigned char bits) const
+{
+  // quadrants, indexed by top-left, top-right, bottom-left, bottom-right
+  static const uint32_t quads[16] =
+  {
+    ' ', 0x2598, 0x259D, 0x2580, 0x2596, 0x258C, 0x259E, 0x259B,
+    0x2597, 0x259A, 0x2590, 0x259C, 0x2584, 0x2599, 0x259F, 0x2588
+  };
+
+  if(!bits) return ' ';
+  return (style == s_braille? 0x2800 + bits: quads[bits]);
+}
+
+
+void
+Canvas::render(string& out)
+{
+  if(full)
+    out += "\033[0m\033[2J";
+
+  uint32_t rgb = 0xFFFFFFFF;
+  int cx = -1;
+  int cy = -1;
+  char buf[32];
+
+  for(int y = 0; y != rows; ++y)
+    for(int x = 0; x != cols; ++x)
+    {
+      const size_t i = static_cast<size_t>(y) * cols + x;
+      Cell c = cells[i];
+      if(!c.ch) c.ch = glyph(bits[i]);
+      if(c.ch == ' ') c.rgb = 0;
+      if(!full && !(c != shown[i]))
+	continue;
+      shown[i] = c;
+
+      // move only when not already following the last cell
+      if(y != cy || x != cx)
+      {
+	snprintf(buf, sizeof(buf), "\033[%d;%dH", y + 1, x + 1);
+	out += buf;
+      }
+      if(c.ch != ' ' && c.rgb != rgb)
+      {
+	snprintf(buf, sizeof(buf), "\033[38;2;%u;%u;%um", c.rgb >> 16,
+	    (c.rgb >> 8) & 0xFF, c.rgb & 0xFF);
+	out += buf;
+	rgb = c.rgb;
+      }
+
+      putUTF8(out, c.ch);
+      cy = y;
+      cx = x + 1;
+    }
+
+  full = false;
+}
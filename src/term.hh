@@ -0,0 +1,119 @@
+/*
+ * term: text-mode canvas for terminals
+ * Copyright(c) 2018 by wave++ "Yuri D'Elia" <wavexx@thregr.org>
+ * Distributed under GNU LGPL WITHOUT ANY WARRANTY.
+ */
+
+#ifndef term_hh
+#define term_hh
+
+// system headers
+#include <string>
+#include <vector>
+
+// c system headers
+#include <stdint.h>
+
+
+/*
+ * A canvas of dots packed into Unicode braille (2x4 dots) or quadrant block
+ * (2x2 dots) characters, where each cell takes the color (0xRRGGBB) of the
+ * last dot set. Text can be written over the dots. Each frame is output as
+ * the difference with the previous one, so that only the changed cells are
+ * rewritten.
+ */
+class Canvas
+{
+public:
+  enum style_t {s_braille, s_block};
+
+private:
+  struct Cell
+  {
+    uint32_t ch;
+    uint32_t rgb;
+
+    bool
+    operator!=(const Cell& c) const
+    {
+      return (ch != c.ch || rgb != c.rgb);
+    }
+  };
+
+  style_t style;
+  int cols;
+  int rows;
+  int dw;
+  int dh;
+  std::vector<unsigned char> bits;
+  std::vector<Cell> cells;
+  std::vector<Cell> shown;
+  bool full;
+
+public:
+  explicit Canvas(style_t style);
+
+  // size in cells (forcing a complete redraw)
+  void resize(int cols, int rows);
+
+  int
+  columns() const
+  {
+    return cols;
+  }
+
+  int
+  lines() const
+  {
+    return rows;
+  }
+
+  // size in dots
+  int
+  width() const
+  {
+    return cols * dw;
+  }
+
+  int
+  height() const
+  {
+    return rows * dh;
+  }
+
+  void clear();
+
+  // set a dot (the origin is top-left, out of range dots are ignored)
+  void
+  dot(int x, int y, uint32_t rgb)
+  {
+    if(x < 0 || y < 0 || x >= cols * dw || y >= rows * dh)
+      return;
+
+    const size_t i = static_cast<size_t>(y / dh) * cols + x / dw;
+    bits[i] |= mask(x % dw, y % dh);
+    cells[i].rgb = rgb;
+  }
+
+  void line(int x0, int y0, int x1, int y1, uint32_t rgb);
+
+  // write text at the given cell (clipped)
+  void text(int col, int row, const std::string& str, uint32_t rgb);
+
+  // append the escape sequences updating the terminal to "out"
+  void render(std::string& out);
+
+private:
+  unsigned char
+  mask(int x, int y) const
+  {
+    // braille dots 1-2-3-7 (left) and 4-5-6-8 (right), quadrants in order
+    static const unsigned char braille[2][4] =
+      {{0x01, 0x02, 0x04, 0x40}, {0x08, 0x10, 0x20, 0x80}};
+    return (style == s_braille? braille[x][y]: 1 << (y * 2 + x));
+  }
+
+  uint32_t glyph(unsigned char bits) const;
+};
+
+#endif
@@ -8,9 +8,21 @@
 #define timer_hh
 
 // c system headers
+#include <stdint.h>
+#include <time.h>
 #include <sys/time.h>
 
 
+// monotonic time (ns)
+inline uint64_t
+monotonic()
+{
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+
 // Averaging stop-watch timer (with variable-bound precision)
 class ATimer
 {
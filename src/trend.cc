@@ -17,6 +17,16 @@
 #include "color.hh"
 #include "timer.hh"
 #include "rr.hh"
+#include "input.hh"
+#include "queue.hh"
+#include "geom.hh"
+#include "draw.hh"
+#include "soft.hh"
+#include "offscreen.hh"
+#include "image.hh"
+#include "video.hh"
+#include "term.hh"
+#include "spectrum.hh"
 using Trend::Value;
 
 // system headers
@@ -57,9 +67,13 @@ using std::strcmp;
 #include <math.h>
 #include <stdio.h>
 #include <ctype.h>
+#include <limits.h>
 #include <sys/stat.h>
 #include <unistd.h>
 #include <pthread.h>
+#include <signal.h>
+#include <time.h>
+#include <sys/ioctl.h>
 
 // OpenGL/GLU
 #include "gl.hh"
@@ -100,6 +114,11 @@ struct Graph
   double zero;
   GLfloat lineCol[3];
   string label;
+
+  // range of the values, shared by all the panes (see setGraphLimits)
+  Value lo;
+  Value hi;
+  bool ranged;
 };
 
 
@@ -110,6 +129,14 @@ operator<(const Intr& l, const Intr& r)
 }
 
 
+struct Input
+{
+  string name;
+  size_t count;
+  Trend::input_t input;
+};
+
+
 struct Grid
 {
   double res;
@@ -123,6 +150,52 @@ struct GrSpec
 };
 
 
+// a view of a subset of the graphs, with its own limits and modes: the
+// settings of the current pane are swapped in and out of the program state
+struct Pane
+{
+  vector<Graph*> shown;
+  Graph* graph;
+  double loLimit;
+  double hiLimit;
+  bool autoLimit;
+  bool dimmed;
+  bool values;
+  bool marker;
+  bool filled;
+  bool showUndef;
+  Trend::view_t view;
+  bool grid;
+  GrSpec grSpec;
+  bool graphKey;
+  size_t maxValue;
+  bool intr;
+  bool intrFg;
+  double intrX;
+  double intrY;
+  bool distrib;
+  vector<double> distribData;
+  Texture* heatTex;
+  vector<uint32_t> heatTexels;
+  vector<size_t> heatPos;
+  double heatLo;
+  double heatHi;
+  size_t heatSerial;
+  bool spectrum;
+  bool peakHold;
+  Spectrum* analyzer;
+  const Graph* specGraph;
+  vector<float> specAvg;
+  vector<float> specPeak;
+
+  // position in the window (origin bottom-left)
+  int x;
+  int y;
+  int width;
+  int height;
+};
+
+
 /*
  * Graph/Program state
  * TODO: refactor! refactor! refactor!
@@ -131,15 +204,22 @@ struct GrSpec
 namespace
 {
   // Basic data
-  const char* fileName;
+  vector<Input> inputs;
   pthread_mutex_t mutex;
+  pthread_cond_t synced;
   volatile bool damaged = false;
+  bool finished = false;
   Trend::input_t input = Trend::input;
   Trend::format_t format = Trend::format;
   bool allowEsc = false;
 
   // Main graph data
   vector<Graph> graphs;
+  vector<pair<size_t, string> > relabels;
+  Queue<Command> commands(Trend::maxCommands);
+  deque<pair<size_t, size_t> > marks;
+  vector<rr<Value>*> rings;
+  vector<Graph*> shown;
   Graph* graph;
   double loLimit;
   double hiLimit;
@@ -155,6 +235,10 @@ namespace
   size_t divisions;
   size_t offset;
   const char* title = NULL;
+  const char* ctlPath = NULL;
+  const char* recPath = NULL;
+  string sinkPath;
+  size_t sinkDecimate = 1;
   GLfloat backCol[3];
   GLfloat textCol[3];
   GLfloat gridCol[3];
@@ -162,7 +246,14 @@ namespace
   GLfloat intrCol[3];
   GLfloat editCol[3];
 
+  // Panes
+  vector<const char*> paneSpecs;
+  vector<Pane> panes;
+  size_t pane = 0;
+
   // Visual/Changeable settings
+  int winWidth;
+  int winHeight;
   int width;
   int height;
   int lc;
@@ -195,12 +286,76 @@ namespace
   bool distrib = Trend::distrib;
   vector<double> distribData;
 
+  // Heatmap view: the texels of each graph row and the count of the next
+  // value to color, up to date with the limits and the zero serial
+  Texture* heatTex = NULL;
+  vector<uint32_t> heatTexels;
+  vector<size_t> heatPos;
+  double heatLo = NAN;
+  double heatHi = NAN;
+  size_t heatSerial = 0;
+  size_t zeroSerial = 0;
+
+  // Spectrum view: the analyzer of the current graph (started on first use)
+  // and its last results
+  bool spectrum = Trend::spectrum;
+  bool peakHold = Trend::peakHold;
+  size_t specSize = Trend::specSize;
+  size_t specAverage = Trend::specAverage;
+  Spectrum* analyzer = NULL;
+  const Graph* specGraph = NULL;
+  vector<float> specAvg;
+  vector<float> specPeak;
+
   // Latency
   bool latency = Trend::latency;
   ATimer atVLat(Trend::latAvg);
   ATimer atBLat(Trend::latAvg);
   double bLat = 0.;
   double vLat = 0.;
+  Stats stats;
+
+  // Input to display latency
+  uint64_t syncStamp = 0;
+  uint64_t frameStamp = 0;
+  Histogram atELat;
+  Histogram atFrame;
+  uint64_t timesLast = 0;
+
+  // Video export
+  const char* videoPath = NULL;
+  Video* video = NULL;
+
+  // Metrics export
+  const char* metricsAddr = NULL;
+  vector<const string*> exportLabels;
+
+  // Profiling
+  bool profiling = false;
+  Profile profile;
+  Histogram::Summary profSums[Profile::stages];
+  uint64_t profLast = 0;
+
+  // Drawing backend (soft when rendering in memory)
+  Draw* draw = NULL;
+  SoftDraw* soft = NULL;
+
+  // Headless rendering
+  bool headless = false;
+  bool softRender = false;
+  int offWidth = Trend::headlessWidth;
+  int offHeight = Trend::headlessHeight;
+  size_t benchFrames = 0;
+  string snapPath;
+  size_t snapEvery = 0;
+  bool lockstep = false;
+  bool dirty = false;
+
+  // Text mode
+  bool textMode = false;
+  Canvas::style_t textStyle = Canvas::s_braille;
+  volatile sig_atomic_t textResized = true;
+  volatile sig_atomic_t textQuit = false;
 
   // Modes
   mode_t mode;
@@ -226,234 +381,308 @@ rrFill(const Graph& g, double v)
 
 // shift values
 void
-rrShift(const Graph& g, double v)
+rrShift(Graph& g, double v)
 {
   for(Value* it = g.rrBuf; it != g.rrEnd; ++it)
     *it -= v;
+  g.ranged = false;
 }
 
 
-// skip whitespace
+// notify new data to the display
 void
-skipSpc(FILE* fd)
+notify(uint64_t stamp)
 {
-  int c;
+  // account for the time spent waiting on the display thread
+  if(pthread_mutex_trylock(&mutex))
+  {
+    uint64_t start = monotonic();
+    pthread_mutex_lock(&mutex);
+    __atomic_add_fetch(&stats.blocked, monotonic() - start, __ATOMIC_RELAXED);
+  }
+  if(!damaged)
+  {
+    atBLat.start();
+    syncStamp = stamp;
+    damaged = true;
+  }
+  if(lockstep)
+  {
+    // hand over the data, waiting until it has been copied
+    pthread_cond_broadcast(&synced);
+    while(damaged)
+      pthread_cond_wait(&synced, &mutex);
+  }
+  pthread_mutex_unlock(&mutex);
+}
+
 
-  do { c = getc_unlocked(fd); }
-  while(isspace(c) && c != EOF);
-  ungetc(c, fd);
+// current value of the shared counters
+Stats
+getStats()
+{
+  Stats s;
+  s.samples = __atomic_load_n(&stats.samples, __ATOMIC_RELAXED);
+  s.overruns = __atomic_load_n(&stats.overruns, __ATOMIC_RELAXED);
+  s.errors = __atomic_load_n(&stats.errors, __ATOMIC_RELAXED);
+  s.blocked = __atomic_load_n(&stats.blocked, __ATOMIC_RELAXED);
+  s.dropped = __atomic_load_n(&stats.dropped, __ATOMIC_RELAXED);
+  s.vidFrames = __atomic_load_n(&stats.vidFrames, __ATOMIC_RELAXED);
+  s.vidDrops = __atomic_load_n(&stats.vidDrops, __ATOMIC_RELAXED);
+  s.cmdDrops = __atomic_load_n(&stats.cmdDrops, __ATOMIC_RELAXED);
+  s.latP50 = __atomic_load_n(&stats.latP50, __ATOMIC_RELAXED);
+  s.latP99 = __atomic_load_n(&stats.latP99, __ATOMIC_RELAXED);
+  s.latMax = __atomic_load_n(&stats.latMax, __ATOMIC_RELAXED);
+  s.frames = __atomic_load_n(&stats.frames, __ATOMIC_RELAXED);
+  s.frameP50 = __atomic_load_n(&stats.frameP50, __ATOMIC_RELAXED);
+  s.frameP99 = __atomic_load_n(&stats.frameP99, __ATOMIC_RELAXED);
+  s.frameMax = __atomic_load_n(&stats.frameMax, __ATOMIC_RELAXED);
+  return s;
 }
 
 
-// skip a space-separated string
+// relabel a graph from the producer thread (named input)
 void
-skipStr(FILE* fd)
+relabel(size_t n, const string& label)
+{
+  // a graph is claimed at most once: the exported label is never freed
+  __atomic_store_n(&exportLabels[n], new string(label), __ATOMIC_RELEASE);
+
+  pthread_mutex_lock(&mutex);
+  relabels.push_back(pair<size_t, string>(n, label));
+  pthread_mutex_unlock(&mutex);
+}
+
+
+// queue an escape/control command for the display thread, dropping it when
+// the queue is full (waiting would stall all the sources)
+bool
+command(const Command& cmd)
 {
-  int c;
+  if(commands.push(cmd))
+    return true;
 
-  do { c = getc_unlocked(fd); }
-  while(!isspace(c) && c != EOF);
-  ungetc(c, fd);
+  __atomic_add_fetch(&stats.cmdDrops, 1, __ATOMIC_RELAXED);
+  return false;
 }
 
 
-// read a space-separated string
-char*
-readStr(FILE* fd, char* buf, size_t len)
+void
+control(const char* line, size_t len, string& reply);
+
+
+// producer thread
+void*
+producer(void* prg)
 {
-  char* p(buf);
-  int c;
+  static const Hooks hooks =
+    {notify, relabel, command, control, &stats, &profile};
+
+  Loop loop;
+  vector<Router*> routers;
+  size_t first = 0;
 
-  while(len--)
+  // processed output of the main input
+  Sink* sink = NULL;
+  if(sinkPath.size())
   {
-    c = getc_unlocked(fd);
-    if(c == EOF || isspace(c))
+    sink = new Sink(sinkPath, sinkDecimate, inputs.front().count, &stats);
+    if(!sink->open())
     {
-      ungetc(c, fd);
-      return p;
+      cerr << reinterpret_cast<char*>(prg) << ": cannot write to "
+	   << sinkPath << "\n";
+      delete sink;
+      sink = NULL;
     }
-    *p++ = c;
   }
 
-  // overflow
-  return NULL;
-}
-
+  // raw input recording
+  Recorder rec;
+  if(recPath && !rec.open(recPath))
+  {
+    cerr << reinterpret_cast<char*>(prg) << ": cannot record to "
+	 << recPath << "\n";
+    recPath = NULL;
+  }
 
-// read a number from an ascii stream
-bool
-readANum(FILE* fd, double& v)
-{
-  for(;;)
+  for(vector<Input>::const_iterator it = inputs.begin();
+      it != inputs.end(); ++it)
   {
-    // read
-    skipSpc(fd);
-    char buf[Trend::maxNumLen];
-    char* end = readStr(fd, buf, sizeof(buf) - 1);
-    if(feof(fd))
-      return false;
+    // series are routed by label for named input
+    Router* router = NULL;
+    if(format == Trend::f_named)
+    {
+      vector<string> names(it->count);
+      for(size_t i = 0; i != it->count; ++i)
+	if(labels.size() > first + i)
+	  names[i] = labels[first + i];
 
-    if(!end)
+      router = new Router(first, names, relabel);
+      routers.push_back(router);
+    }
+
+    Feed feed(&rings[0], first, it->count, it->input, allowEsc, &hooks, router);
+    if(it == inputs.begin())
     {
-      // long string, skip it.
-      skipStr(fd);
-      continue;
+      feed.output(sink);
+      if(lockstep) feed.every(snapEvery);
     }
-    *end = 0;
+    first += it->count;
 
-    // convert the number
-    v = strtod(buf, &end);
-    if(end != buf)
-      break;
+    Source* src = newSource(it->name, format, feed);
+    src->tap((recPath? &rec: NULL), it - inputs.begin());
+    if(!loop.add(src))
+      cerr << reinterpret_cast<char*>(prg) << ": cannot open input "
+	   << it->name << "\n";
   }
 
-  return true;
-}
+  // remote control interface
+  if(ctlPath && !loop.add(new Control(ctlPath, &hooks)))
+    cerr << reinterpret_cast<char*>(prg) << ": cannot open control interface "
+	 << ctlPath << "\n";
 
+  // serve all the sources until exhausted
+  loop.run();
+  pthread_mutex_lock(&mutex);
+  finished = true;
+  pthread_cond_broadcast(&synced);
+  pthread_mutex_unlock(&mutex);
+  for(vector<Router*>::iterator it = routers.begin(); it != routers.end(); ++it)
+    delete *it;
+  delete sink;
 
-// read a number from a binary stream
-template <class T> bool
-readNum(FILE* fd, double& v)
-{
-  T buf;
-  if(fread(&buf, sizeof(buf), 1, fd) != 1)
-    return false;
-
-  v = static_cast<double>(buf);
-  return true;
+  cerr << reinterpret_cast<char*>(prg) << ": producer thread exiting\n";
+  return NULL;
 }
 
 
-// read up to the first number in the stream using the current format
-bool
-readFNum(FILE* fd, double& v)
+// append a metric header
+void
+putMetric(string& out, const char* name, const char* type, const char* help)
 {
-  switch(format)
-  {
-  case Trend::f_ascii: return readANum(fd, v);
-  case Trend::f_float: return readNum<float>(fd, v);
-  case Trend::f_double: return readNum<double>(fd, v);
-  case Trend::f_short: return readNum<short>(fd, v);
-  case Trend::f_int: return readNum<int>(fd, v);
-  case Trend::f_long: return readNum<long>(fd, v);
-  }
+  out += "# HELP ";
+  out += name;
+  out += ' ';
+  out += help;
+  out += "\n# TYPE ";
+  out += name;
+  out += ' ';
+  out += type;
+  out += '\n';
+}
 
-  return false;
+// append a sample (labels are already formatted)
+void
+putSample(string& out, const char* name, const char* labels, double v)
+{
+  char buf[64];
+  if(isnan(v)) strcpy(buf, "NaN");
+  else if(isinf(v)) strcpy(buf, (v > 0? "+Inf": "-Inf"));
+  else snprintf(buf, sizeof(buf), "%.17g", v);
+
+  out += name;
+  if(labels) out += labels;
+  out += ' ';
+  out += buf;
+  out += '\n';
 }
 
+// append a metric with a single, unlabeled value
+void
+putMetric(string& out, const char* name, const char* type, const char* help,
+    double v)
+{
+  putMetric(out, name, type, help);
+  putSample(out, name, NULL, v);
+}
 
-// read/handle incoming escape sequences
-bool
-readEsc(FILE* fd)
+// append the quantiles of a summary (durations in ns)
+void
+putSummary(string& out, const char* name, const char* help, uint64_t p50,
+    uint64_t p99, uint64_t max)
 {
-  // TODO: incomplete
-  return true;
+  putMetric(out, name, "summary", help);
+  putSample(out, name, "{quantile=\"0.5\"}", p50 / 1e9);
+  putSample(out, name, "{quantile=\"0.99\"}", p99 / 1e9);
+  putSample(out, name, "{quantile=\"1\"}", max / 1e9);
 }
 
 
-// read the next valid element from the stream
-bool
-readNext(FILE* fd, double& v)
+// format the metrics export (from the exporter thread)
+void
+metrics(string& out)
 {
-  if(!allowEsc)
-    return readFNum(fd, v);
-
-  while(readFNum(fd, v))
+  const Stats s = getStats();
+  putMetric(out, "trend_samples_total", "counter",
+      "Values received.", s.samples);
+  putMetric(out, "trend_overruns_total", "counter",
+      "Values overwritten before being displayed.", s.overruns);
+  putMetric(out, "trend_parse_errors_total", "counter",
+      "Unparsable values or lines skipped.", s.errors);
+  putMetric(out, "trend_blocked_seconds_total", "counter",
+      "Time the input thread waited for the display.", s.blocked / 1e9);
+  putMetric(out, "trend_dropped_frames_total", "counter",
+      "Frames dropped by the output.", s.dropped);
+  putMetric(out, "trend_video_frames_total", "counter",
+      "Frames written to the video output.", s.vidFrames);
+  putMetric(out, "trend_video_dropped_total", "counter",
+      "Frames dropped by the video output.", s.vidDrops);
+  putMetric(out, "trend_commands_dropped_total", "counter",
+      "Commands dropped as the display queue was full.", s.cmdDrops);
+  putMetric(out, "trend_frames_total", "counter",
+      "Frames drawn.", s.frames);
+  putSummary(out, "trend_frame_seconds",
+      "Frame drawing time.", s.frameP50, s.frameP99, s.frameMax);
+  putSummary(out, "trend_latency_seconds",
+      "Input to display latency.", s.latP50, s.latP99, s.latMax);
+
+  // resident memory
+  unsigned long size, rss;
+  FILE* statm = fopen("/proc/self/statm", "r");
+  if(statm)
   {
-    if(!isinf(v))
-      return true;
-    if(!readEsc(fd))
-      break;
+    if(fscanf(statm, "%lu %lu", &size, &rss) == 2)
+      putMetric(out, "process_resident_memory_bytes", "gauge",
+	  "Resident memory size in bytes.",
+	  static_cast<double>(rss) * sysconf(_SC_PAGESIZE));
+    fclose(statm);
   }
 
-  return false;
+  // last value of each graph
+  putMetric(out, "trend_value", "gauge", "Last value of each graph.");
+  string labels;
+  char buf[32];
+  for(size_t i = 0; i != rings.size(); ++i)
+  {
+    const string* label = __atomic_load_n(&exportLabels[i], __ATOMIC_ACQUIRE);
+    snprintf(buf, sizeof(buf), "{graph=\"%lu\",label=\"",
+	static_cast<unsigned long>(i + 1));
+    labels = buf;
+    for(string::const_iterator c = label->begin(); c != label->end(); ++c)
+    {
+      if(*c == '\\' || *c == '"') labels += '\\';
+      if(*c == '\n') labels += "\\n";
+      else labels += *c;
+    }
+    labels += "\"}";
+    putSample(out, "trend_value", labels.c_str(), rings[i]->last());
+  }
 }
 
 
-// producer thread
+// metrics exporter thread
 void*
-producer(void* prg)
+exporter(void* prg)
 {
-  // iostreams under gcc 3.x are completely unusable for advanced tasks such as
-  // customizable buffering/locking/etc. They also removed the (really
-  // standard) ->fd() access for "encapsulation"...
-  FILE* in;
-
-  // some buffers
-  size_t ng = graphs.size();
-  double* old = new double[ng];
-
-  for(;;)
+  Loop loop;
+  if(!loop.add(new Metrics(metricsAddr, metrics)))
   {
-    // open the file and disable buffering
-    in = (*fileName? fopen(fileName, "r"): stdin);
-    if(!in) break;
-    setvbuf(in, NULL, _IONBF, 0);
-
-    // check for useless file types
-    struct stat stBuf;
-    fstat(fileno(in), &stBuf);
-    if(S_ISDIR(stBuf.st_mode))
-      break;
-
-    // first value for incremental data
-    if(input != Trend::absolute)
-      for(size_t i = 0; i != ng; ++i)
-	if(!readNext(in, old[i]))
-	  goto end;
-
-    // read all data
-    for(;;)
-    {
-      for(size_t i = 0; i != ng; ++i)
-      {
-	double num;
-	if(!readNext(in, num))
-	  goto end;
-
-	// determine the actual value
-	switch(input)
-	{
-	case Trend::incremental:
-	  {
-	    double tmp = num;
-	    num -= old[i];
-	    old[i] = tmp;
-	  }
-	  break;
-
-	case Trend::differential:
-	  old[i] += num;
-	  num = old[i];
-	  break;
-
-	default:;
-	}
-
-	// append the value
-	graphs[i].rrData->push_back(num);
-      }
-
-      // notify
-      pthread_mutex_lock(&mutex);
-      if(!damaged)
-      {
-	atBLat.start();
-	damaged = true;
-      }
-      pthread_mutex_unlock(&mutex);
-    }
-
-  end:
-    // close the stream and terminate the loop for regular files
-    fclose(in);
-    if(S_ISREG(stBuf.st_mode) || S_ISBLK(stBuf.st_mode))
-      break;
+    cerr << reinterpret_cast<char*>(prg) << ": cannot open metrics endpoint "
+	 << metricsAddr << "\n";
+    return NULL;
   }
 
-  // should never get so far
-  delete []old;
-  cerr << reinterpret_cast<char*>(prg) << ": producer thread exiting\n";
+  loop.run();
   return NULL;
 }
 
@@ -486,25 +715,126 @@ unproject(int xi, int yi, double& xo, double& yo)
 }
 
 
-// OpenGL state initializer
+// drawing state initializer
 void
 init()
 {
-  // Smoothing
-  if(smooth)
+  // text mode doesn't draw
+  if(draw) draw->init(backCol, smooth);
+}
+
+
+// stack the panes vertically, the first one on top
+void
+layoutPanes()
+{
+  const int n = panes.size();
+  for(int i = 0; i != n; ++i)
   {
-    glEnable(GL_LINE_SMOOTH);
-    glHint(GL_LINE_SMOOTH_HINT, GL_FASTEST);
+    Pane& p = panes[i];
+    const int top = winHeight * i / n;
+    const int bottom = winHeight * (i + 1) / n;
+    p.x = 0;
+    p.y = winHeight - bottom;
+    p.width = winWidth;
+    p.height = bottom - top;
   }
-  else
-    glDisable(GL_LINE_SMOOTH);
+}
+
+
+// store the settings in use to a pane
+void
+savePane(Pane& p)
+{
+  p.shown = shown;
+  p.graph = graph;
+  p.loLimit = loLimit;
+  p.hiLimit = hiLimit;
+  p.autoLimit = autoLimit;
+  p.dimmed = dimmed;
+  p.values = values;
+  p.marker = marker;
+  p.filled = filled;
+  p.showUndef = showUndef;
+  p.view = view;
+  p.grid = grid;
+  p.grSpec = grSpec;
+  p.graphKey = graphKey;
+  p.maxValue = maxValue;
+  p.intr = intr;
+  p.intrFg = intrFg;
+  p.intrX = intrX;
+  p.intrY = intrY;
+  p.distrib = distrib;
+  p.distribData.swap(distribData);
+  p.heatTex = heatTex;
+  p.heatTexels.swap(heatTexels);
+  p.heatPos.swap(heatPos);
+  p.heatLo = heatLo;
+  p.heatHi = heatHi;
+  p.heatSerial = heatSerial;
+  p.spectrum = spectrum;
+  p.peakHold = peakHold;
+  p.analyzer = analyzer;
+  p.specGraph = specGraph;
+  p.specAvg.swap(specAvg);
+  p.specPeak.swap(specPeak);
+}
+
 
-  // Blending should be enabled by default
-  glEnable(GL_BLEND);
-  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+// use the settings of a pane
+void
+loadPane(Pane& p)
+{
+  shown = p.shown;
+  graph = p.graph;
+  loLimit = p.loLimit;
+  hiLimit = p.hiLimit;
+  autoLimit = p.autoLimit;
+  dimmed = p.dimmed;
+  values = p.values;
+  marker = p.marker;
+  filled = p.filled;
+  showUndef = p.showUndef;
+  view = p.view;
+  grid = p.grid;
+  grSpec = p.grSpec;
+  graphKey = p.graphKey;
+  maxValue = p.maxValue;
+  intr = p.intr;
+  intrFg = p.intrFg;
+  intrX = p.intrX;
+  intrY = p.intrY;
+  distrib = p.distrib;
+  distribData.swap(p.distribData);
+  heatTex = p.heatTex;
+  heatTexels.swap(p.heatTexels);
+  heatPos.swap(p.heatPos);
+  heatLo = p.heatLo;
+  heatHi = p.heatHi;
+  heatSerial = p.heatSerial;
+  spectrum = p.spectrum;
+  peakHold = p.peakHold;
+  analyzer = p.analyzer;
+  specGraph = p.specGraph;
+  specAvg.swap(p.specAvg);
+  specPeak.swap(p.specPeak);
+}
+
+
+// switch to the settings and size of pane n
+void
+selectPane(size_t n)
+{
+  if(n != pane)
+  {
+    savePane(panes[pane]);
+    loadPane(panes[n]);
+    pane = n;
+  }
 
-  // Clear color
-  glClearColor(backCol[0], backCol[1], backCol[2], 0.0);
+  width = panes[n].width;
+  height = panes[n].height;
 }
 
 
@@ -512,10 +842,12 @@ init()
 void
 reshape(const int w, const int h)
 {
-  width = w;
-  height = h;
+  winWidth = w;
+  winHeight = h;
+  layoutPanes();
+  selectPane(pane);
 
-  glViewport(0, 0, w, h);
+  draw->resize(w, h);
 }
 
 
@@ -523,11 +855,7 @@ reshape(const int w, const int h)
 void
 drawString(const int x, const int y, const string& str)
 {
-  glRasterPos2i(0, 0);
-  glBitmap(0, 0, 0, 0, x, y, NULL);
-
-  for(string::const_iterator p = str.begin(); p != str.end(); ++p)
-    glutBitmapCharacter(GLUT_BITMAP_8_BY_13, *p);
+  draw->text(x, y, str);
 }
 
 
@@ -582,22 +910,22 @@ drawGridX(double gridres)
 {
   // horizontal lines
   double it;
-  glBegin(GL_LINES);
+  draw->begin(Draw::p_lines);
 
   if(scroll)
     for(it = divisions; it > 0; it -= gridres)
     {
-      glVertex2d(it, loLimit);
-      glVertex2d(it, hiLimit);
+      draw->vertex(it, loLimit);
+      draw->vertex(it, hiLimit);
     }
   else
     for(it = gridres; it <= divisions; it += gridres)
     {
-      glVertex2d(it, loLimit);
-      glVertex2d(it, hiLimit);
+      draw->vertex(it, loLimit);
+      draw->vertex(it, hiLimit);
     }
 
-  glEnd();
+  draw->end();
 }
 
 
@@ -609,13 +937,13 @@ drawGridY(double gridres)
   if(it <= loLimit)
     it += gridres;
 
-  glBegin(GL_LINES);
+  draw->begin(Draw::p_lines);
   for(; it < hiLimit; it += gridres)
   {
-    glVertex2d(0, it);
-    glVertex2d(divisions, it);
+    draw->vertex(0, it);
+    draw->vertex(divisions, it);
   }
-  glEnd();
+  draw->end();
 }
 
 
@@ -634,14 +962,14 @@ drawGrid()
     // minor lines
     if(grSpec.x.mayor != 1 && r < d)
     {
-      glColor4f(gridCol[0], gridCol[1], gridCol[2], 0.5);
+      draw->color(gridCol[0], gridCol[1], gridCol[2], 0.5);
       drawGridX(grSpec.x.res);
     }
 
     // mayor lines
     if(grSpec.x.mayor)
     {
-      glColor3fv(gridCol);
+      draw->color(gridCol);
       drawGridX(grSpec.x.res * grSpec.x.mayor);
     }
   }
@@ -655,14 +983,14 @@ drawGrid()
     // minor lines
     if(grSpec.y.mayor != 1 && r < d)
     {
-      glColor4f(gridCol[0], gridCol[1], gridCol[2], 0.5);
+      draw->color(gridCol[0], gridCol[1], gridCol[2], 0.5);
       drawGridY(grSpec.y.res);
     }
 
     // mayor lines
     if(grSpec.y.mayor)
     {
-      glColor3fv(gridCol);
+      draw->color(gridCol);
       drawGridY(grSpec.y.res * grSpec.y.mayor);
     }
   }
@@ -672,11 +1000,37 @@ drawGrid()
 void
 drawMarker(const double x)
 {
-  glColor3fv(markCol);
-  glBegin(GL_LINES);
-  glVertex2d(x, loLimit);
-  glVertex2d(x, hiLimit);
-  glEnd();
+  draw->color(markCol);
+  draw->begin(Draw::p_lines);
+  draw->vertex(x, loLimit);
+  draw->vertex(x, hiLimit);
+  draw->end();
+}
+
+
+void
+drawMarks()
+{
+  draw->color(markCol[0], markCol[1], markCol[2], 0.5);
+  draw->begin(Draw::p_lines);
+
+  for(deque<pair<size_t, size_t> >::const_iterator it = marks.begin();
+      it != marks.end(); ++it)
+  {
+    // only marks still in the history
+    const Graph& g = graphs[it->first];
+    if(it->second > g.rrPos || g.rrPos - it->second >= history)
+      continue;
+
+    size_t i = offset + history - (g.rrPos - it->second);
+    size_t x = (scroll? i: it->second) % divisions;
+    if(!x) x = divisions;
+
+    draw->vertex(x, loLimit);
+    draw->vertex(x, hiLimit);
+  }
+
+  draw->end();
 }
 
 
@@ -686,12 +1040,12 @@ drawCircle(const int x, const int y)
   using Trend::intrRad;
 
   // ok, it's not really a circle.
-  glBegin(GL_LINE_LOOP);
-  glVertex2i(x - intrRad, y);
-  glVertex2i(x, y + intrRad);
-  glVertex2i(x + intrRad, y);
-  glVertex2i(x, y - intrRad);
-  glEnd();
+  draw->begin(Draw::p_lineLoop);
+  draw->vertex(x - intrRad, y);
+  draw->vertex(x, y + intrRad);
+  draw->vertex(x + intrRad, y);
+  draw->vertex(x, y - intrRad);
+  draw->end();
 }
 
 
@@ -710,70 +1064,31 @@ getPosition(const Graph& g, size_t pos, const Value* v)
 }
 
 
-size_t
-drawLine(const Graph& g, double alphaMul)
+// drawing output of walkLine
+struct LineOut
 {
-  const Value* it = g.rrBuf;
-  const Value* nit = it + 1;
-  const size_t mark(history + offset - divisions - 1);
-  bool st = false;
-  size_t pos = 0;
+  const GLfloat* col;
+  double alphaMul;
 
-  for(size_t i = offset; it != g.rrEnd; ++i, ++it, ++nit)
+  void
+  shade(double alpha)
   {
-    if(!st && isfinite(*it) && (nit == g.rrEnd || isfinite(*nit)))
-    {
-      st = true;
-      glBegin(GL_LINE_STRIP);
-    }
-
-    // shade the color
-    double alpha(dimmed?
-	(i > mark? 1.: .5):
-	(static_cast<float>(i - offset) / history));
-
-    glColor4f(g.lineCol[0], g.lineCol[1], g.lineCol[2], alpha * alphaMul);
-    pos = getPosition(g, i, it);
+    draw->color(col[0], col[1], col[2], alpha * alphaMul);
+  }
 
-    if(st)
-    {
-      if(pos)
-	glVertex2d(pos, *it);
-      else
-      {
-	// Cursor at the end
-	glVertex2d(divisions, *it);
-	glEnd();
-	glBegin(GL_LINE_STRIP);
-	glVertex2d(0, *it);
-      }
-    }
-    else if(isfinite(*it))
-    {
-      glBegin(GL_LINES);
-      if(pos)
-      {
-	glVertex2d(pos - 0.5, *it);
-	glVertex2d(pos + 0.5, *it);
-      }
-      else
-      {
-	glVertex2d(0, *it);
-	glVertex2d(0.5, *it);
-	glVertex2d(divisions, *it);
-	glVertex2d(divisions - 0.5, *it);
-      }
-      glEnd();
-    }
+  void strip() { draw->begin(Draw::p_lineStrip); }
+  void lines() { draw->begin(Draw::p_lines); }
+  void vertex(double x, double y) { draw->vertex(x, y); }
+  void end() { draw->end(); }
+};
 
-    if(st && (nit == g.rrEnd || !isfinite(*nit)))
-    {
-      glEnd();
-      st = false;
-    }
-  }
 
-  return pos;
+size_t
+drawLine(const Graph& g, double alphaMul)
+{
+  const LineSpec spec = {history, offset, divisions, g.rrPos, scroll, dimmed};
+  LineOut out = {g.lineCol, alphaMul};
+  return walkLine(g.rrBuf, g.rrEnd, spec, out);
 }
 
 
@@ -787,14 +1102,14 @@ drawFillZero(const Graph& g)
   bool st = false;
   Value last = NAN;
 
-  glColor4f(g.lineCol[0], g.lineCol[1], g.lineCol[2], Trend::fillTrendAlpha);
+  draw->color(g.lineCol[0], g.lineCol[1], g.lineCol[2], Trend::fillTrendAlpha);
   for(size_t i = mark; it != g.rrEnd; ++i, ++it, ++nit)
   {
     if(!st && isfinite(*it) && (nit == g.rrEnd || isfinite(*nit)))
     {
       last = *it;
       st = true;
-      glBegin(GL_QUAD_STRIP);
+      draw->begin(Draw::p_quadStrip);
     }
 
     if(st)
@@ -805,31 +1120,31 @@ drawFillZero(const Graph& g)
       {
 	// extra truncation needed
 	double zt = (pos? pos: divisions) - *it / (*it - last);
-	glVertex2d(zt, 0);
-	glVertex2d(zt, 0);
+	draw->vertex(zt, 0);
+	draw->vertex(zt, 0);
       }
 
       last = *it;
 
       if(pos)
       {
-	glVertex2d(pos, *it);
-	glVertex2d(pos, 0);
+	draw->vertex(pos, *it);
+	draw->vertex(pos, 0);
       }
       else
       {
 	// cursor at the end
-	glVertex2d(divisions, *it);
-	glVertex2d(divisions, 0);
-	glEnd();
-	glBegin(GL_QUAD_STRIP);
-	glVertex2d(0, *it);
-	glVertex2d(0, 0);
+	draw->vertex(divisions, *it);
+	draw->vertex(divisions, 0);
+	draw->end();
+	draw->begin(Draw::p_quadStrip);
+	draw->vertex(0, *it);
+	draw->vertex(0, 0);
       }
 
       if(nit == g.rrEnd || !isfinite(*nit))
       {
-	glEnd();
+	draw->end();
 	st = false;
       }
     }
@@ -848,8 +1163,8 @@ drawFillDelta(const Graph& g)
   Value l1 = NAN;
   Value l2 = NAN;
 
-  glColor4f(g.lineCol[0], g.lineCol[1], g.lineCol[2], Trend::fillTrendAlpha);
-  glBegin(GL_QUAD_STRIP);
+  draw->color(g.lineCol[0], g.lineCol[1], g.lineCol[2], Trend::fillTrendAlpha);
+  draw->begin(Draw::p_quadStrip);
   for(size_t i = mark; it != g.rrEnd; ++i, ++it, ++nit)
   {
     Value v1 = *it;
@@ -861,7 +1176,7 @@ drawFillDelta(const Graph& g)
       l1 = v1;
       l2 = v2;
       st = true;
-      glBegin(GL_QUAD_STRIP);
+      draw->begin(Draw::p_quadStrip);
     }
 
     if(st)
@@ -874,24 +1189,24 @@ drawFillDelta(const Graph& g)
 	double r = (l1 - l2) / (l1 - v1 - l2 + v2);
 	double zx = (pos? pos: divisions) - 1 + r;
 	double zy = l1 + (v1 - l1) * r;
-	glVertex2d(zx, zy);
-	glVertex2d(zx, zy);
+	draw->vertex(zx, zy);
+	draw->vertex(zx, zy);
       }
 
       if(pos)
       {
-	glVertex2d(pos, v1);
-	glVertex2d(pos, v2);
+	draw->vertex(pos, v1);
+	draw->vertex(pos, v2);
       }
       else
       {
 	// cursor at the end
-	glVertex2d(divisions, v1);
-	glVertex2d(divisions, v2);
-	glEnd();
-	glBegin(GL_QUAD_STRIP);
-	glVertex2d(0, v1);
-	glVertex2d(0, v2);
+	draw->vertex(divisions, v1);
+	draw->vertex(divisions, v2);
+	draw->end();
+	draw->begin(Draw::p_quadStrip);
+	draw->vertex(0, v1);
+	draw->vertex(0, v2);
       }
 
       l1 = v1;
@@ -899,7 +1214,7 @@ drawFillDelta(const Graph& g)
 
       if(nit == g.rrEnd || !isfinite(*nit) || !isfinite(*(nit - divisions)))
       {
-	glEnd();
+	draw->end();
 	st = false;
       }
     }
@@ -925,13 +1240,13 @@ drawFillUndef(const Graph& g)
   bool st = false;
   size_t pos;
 
-  glColor4f(g.lineCol[0], g.lineCol[1], g.lineCol[2], Trend::fillUndefAlpha);
+  draw->color(g.lineCol[0], g.lineCol[1], g.lineCol[2], Trend::fillUndefAlpha);
   for(size_t i = mark; it != g.rrEnd; ++i, ++it, ++nit)
   {
     if(!st && ((nit == g.rrEnd && !isfinite(*it)) || !isfinite(*nit)))
     {
       st = true;
-      glBegin(GL_QUAD_STRIP);
+      draw->begin(Draw::p_quadStrip);
     }
 
     if(st)
@@ -940,22 +1255,22 @@ drawFillUndef(const Graph& g)
 
       if(pos)
       {
-	glVertex2d(pos, loLimit);
-	glVertex2d(pos, hiLimit);
+	draw->vertex(pos, loLimit);
+	draw->vertex(pos, hiLimit);
       }
       else
       {
-	glVertex2d(divisions, loLimit);
-	glVertex2d(divisions, hiLimit);
-	glEnd();
-	glBegin(GL_QUAD_STRIP);
-	glVertex2d(0, loLimit);
-	glVertex2d(0, hiLimit);
+	draw->vertex(divisions, loLimit);
+	draw->vertex(divisions, hiLimit);
+	draw->end();
+	draw->begin(Draw::p_quadStrip);
+	draw->vertex(0, loLimit);
+	draw->vertex(0, hiLimit);
       }
 
       if(nit == g.rrEnd || (isfinite(*it) && isfinite(*nit)))
       {
-	glEnd();
+	draw->end();
 	st = false;
       }
     }
@@ -963,81 +1278,214 @@ drawFillUndef(const Graph& g)
 }
 
 
-void
-drawDistrib()
+// color of a value in the heatmap (undefined values are transparent)
+inline uint32_t
+heatTexel(Value v, double scale)
 {
-  // reallocate only if necessary. we must avoid to reallocate in order to
-  // not fragment memory (resize() on gcc 3 isn't very friendly)
-  if(distribData.size() != static_cast<size_t>(height))
-    distribData.resize(height);
+  return (isfinite(v)? heatColor((v - loLimit) * scale): 0);
+}
 
-  // calculate distribution
-  const Value* it = graph->rrBuf;
-  const Value* end = graph->rrEnd - 1;
 
-  distribData.assign(distribData.size(), 0.);
-  double max = 0;
+// each graph is a row (the first on top) of a texture colored by value, where
+// only the columns of the values received since the last frame are replaced:
+// the rows are fully recolored only when the limits or the zeros change
+size_t
+drawHeatmap()
+{
+  const size_t w = divisions;
+  const size_t h = shown.size();
+  bool full = (heatLo != loLimit || heatHi != hiLimit ||
+      heatSerial != zeroSerial);
+  if(!heatTex || heatTexels.size() != w * h)
+  {
+    delete heatTex;
+    heatTex = draw->texture(w, h);
+    heatTexels.assign(w * h, 0);
+    heatPos.assign(h, 0);
+    full = true;
+  }
+  heatLo = loLimit;
+  heatHi = hiLimit;
+  heatSerial = zeroSerial;
+
+  const double scale = 1. / (hiLimit - loLimit);
+  vector<char> dirty(w, full);
+  for(size_t r = 0; r != h; ++r)
+  {
+    const Graph& g = *shown[r];
+    uint32_t* row = &heatTexels[(h - 1 - r) * w];
+    size_t c = heatPos[r];
+    if(full || g.rrPos < c || g.rrPos - c >= w)
+    {
+      std::fill(row, row + w, 0);
+      std::fill(dirty.begin(), dirty.end(), true);
+      c = g.rrPos - std::min(g.rrPos, w);
+    }
+
+    // column of each count, clearing the values leaving the history
+    for(; c != g.rrPos; ++c)
+    {
+      const size_t age = g.rrPos - c;
+      row[c % w] = (age > history? 0: heatTexel(g.rrEnd[-age], scale));
+      dirty[c % w] = true;
+      if(history < w && c >= history)
+      {
+	row[(c - history) % w] = 0;
+	dirty[(c - history) % w] = true;
+      }
+    }
+    heatPos[r] = g.rrPos;
+  }
 
-  for(; it != end; ++it)
+  // upload the runs of replaced columns
+  for(size_t x = 0; x != w;)
   {
-    const Value* a = it;
-    const Value* b = (it + 1);
-    if(!isfinite(*a) || !isfinite(*b)) continue;
+    if(!dirty[x])
+    {
+      ++x;
+      continue;
+    }
+
+    size_t e = x + 1;
+    while(e != w && dirty[e]) ++e;
+    heatTex->update(x, e - x, &heatTexels[0]);
+    x = e;
+  }
+
+  // when scrolling the texture is rotated to put the last value in place
+  const size_t shift =
+      (scroll? (offset + history + w - graph->rrPos % w) % w: 0);
+  draw->blit(heatTex, 0, w - shift, shift, loLimit, w, hiLimit);
+  if(shift) draw->blit(heatTex, w - shift, w, 0, loLimit, shift, hiLimit);
 
-    // projection
-    double mul = (static_cast<double>(height) / (hiLimit - loLimit));
-    int begin = static_cast<int>(mul * (*a - loLimit));
-    int end = static_cast<int>(mul * (*b - loLimit));
-    if(begin > end) std::swap(begin, end);
+  return (graph->rrPos + w - 1) % w;
+}
 
-    // fixation
-    if(end < 0 || begin > height) continue;
-    if(begin < 0) begin = 0;
-    if(end > height) end = height;
 
-    // integration
-    for(int y = begin; y != end; ++y)
+// power spectrum of the current graph (dB, the range following the highest
+// bin) over the frequency relative to the sampling rate, from 0 to 0.5
+void
+drawSpectrum()
+{
+  const vector<float>& top = (peakHold? specPeak: specAvg);
+  double hi = 0.;
+  if(top.size())
+    hi = ceil(*std::max_element(top.begin(), top.end()) / 10.) * 10.;
+  const double lo = hi - Trend::specRange;
+  const double right = specSize / 2;
+  draw->ortho(0, right, lo, hi);
+
+  if(grid)
+  {
+    // every 10dB and every 0.05
+    draw->color(gridCol);
+    draw->begin(Draw::p_lines);
+    for(double y = lo + 10.; y < hi; y += 10.)
     {
-      if(++distribData[y] > max)
-	max = distribData[y];
+      draw->vertex(0, y);
+      draw->vertex(right, y);
     }
+    for(int i = 1; i != 10; ++i)
+    {
+      draw->vertex(right * i / 10, lo);
+      draw->vertex(right * i / 10, hi);
+    }
+    draw->end();
+  }
+
+  const GLfloat* col = graph->lineCol;
+  if(peakHold && specPeak.size())
+  {
+    draw->color(col[0], col[1], col[2], Trend::drawOthersAlpha);
+    draw->begin(Draw::p_lineStrip);
+    for(size_t k = 0; k != specPeak.size(); ++k)
+      draw->vertex(k, specPeak[k]);
+    draw->end();
+  }
+  if(specAvg.size())
+  {
+    draw->color(col);
+    draw->begin(Draw::p_lineStrip);
+    for(size_t k = 0; k != specAvg.size(); ++k)
+      draw->vertex(k, specAvg[k]);
+    draw->end();
+  }
+
+  // setup video coordinates
+  draw->ortho(0, width, 0, height);
+  char buf[256];
+  draw->color(textCol);
+
+  if(values)
+  {
+    snprintf(buf, sizeof(buf), "%gdB", lo);
+    drawOSString(width, 0, buf);
+    snprintf(buf, sizeof(buf), "%gdB", hi);
+    drawOSString(width, height, buf);
+  }
+
+  // strongest frequency
+  if(specAvg.empty())
+    snprintf(buf, sizeof(buf), "spectrum: waiting for %lu values",
+	static_cast<unsigned long>(specSize));
+  else
+  {
+    size_t k = std::max_element(specAvg.begin(), specAvg.end()) -
+	specAvg.begin();
+    snprintf(buf, sizeof(buf), "%s%speak: %g (%.1fdB)",
+	(graphKey? "": graph->label.c_str()), (graphKey? "": ": "),
+	static_cast<double>(k) / specSize, specAvg[k]);
   }
+  drawLEString(buf);
+}
+
+
+void
+drawDistrib()
+{
+  // reallocate only if necessary. we must avoid to reallocate in order to
+  // not fragment memory (resize() on gcc 3 isn't very friendly)
+  if(distribData.size() != static_cast<size_t>(height))
+    distribData.resize(height);
+
+  // calculate distribution
+  double max = integrate(graph->rrBuf, graph->rrEnd, loLimit, hiLimit, height,
+      &distribData[0]);
   if(max != 0.)
     max = 1. / max;
 
   // draw the results (optimize for continue zones)
-  glPushMatrix();
-  glLoadIdentity();
-  gluOrtho2D(0, width, 0, height);
+  draw->push();
+  draw->ortho(0, width, 0, height);
 
   using Trend::distribWidth;
   double oldColor = distribData[0] * max;
-  glColor3d(oldColor, oldColor, oldColor);
+  draw->color(oldColor, oldColor, oldColor);
 
-  glBegin(GL_QUADS);
-  glVertex2i(0, 0);
-  glVertex2i(distribWidth, 0);
+  draw->begin(Draw::p_quads);
+  draw->vertex(0, 0);
+  draw->vertex(distribWidth, 0);
 
   for(int y = 1; y != (height - 1); ++y)
   {
     double color = distribData[y] * max;
     if(color != oldColor)
     {
-      glVertex2i(distribWidth, y);
-      glVertex2i(0, y);
+      draw->vertex(distribWidth, y);
+      draw->vertex(0, y);
 
       oldColor = color;
-      glColor3d(color, color, color);
+      draw->color(color, color, color);
 
-      glVertex2i(0, y);
-      glVertex2i(distribWidth, y);
+      draw->vertex(0, y);
+      draw->vertex(distribWidth, y);
     }
   }
 
-  glVertex2i(distribWidth, height);
-  glVertex2i(0, height);
-  glEnd();
-  glPopMatrix();
+  draw->vertex(distribWidth, height);
+  draw->vertex(0, height);
+  draw->end();
+  draw->pop();
 }
 
 
@@ -1048,11 +1496,11 @@ drawTIntr()
   const double intrX = (::intrX < 0 || ::intrX > divisions? 0: ::intrX);
 
   // initial color and current position
-  glColor3fv(intrCol);
-  glBegin(GL_LINES);
-  glVertex2d(intrX, loLimit);
-  glVertex2d(intrX, hiLimit);
-  glEnd();
+  draw->color(intrCol);
+  draw->begin(Draw::p_lines);
+  draw->vertex(intrX, loLimit);
+  draw->vertex(intrX, hiLimit);
+  draw->end();
 
   // scan for all intersections
   size_t trX = (static_cast<size_t>(floor(intrX)));
@@ -1111,21 +1559,20 @@ drawTIntr()
 
   // draw intersections and estimate mean value
   double mean = 0;
-  glBegin(GL_LINES);
+  draw->begin(Draw::p_lines);
   for(vector<Intr>::const_iterator it = intrs.begin();
       it != intrs.end(); ++it)
   {
     mean += it->value;
-    glVertex2d(0, it->value);
-    glVertex2d(divisions, it->value);
+    draw->vertex(0, it->value);
+    draw->vertex(divisions, it->value);
   }
-  glEnd();
+  draw->end();
   mean /= intrs.size();
 
   // switch to video coordinates
-  glPushMatrix();
-  glLoadIdentity();
-  gluOrtho2D(0, width, 0, height);
+  draw->push();
+  draw->ortho(0, width, 0, height);
 
   // nearest point
   int nearX, nearY;
@@ -1152,7 +1599,7 @@ drawTIntr()
   }
 
   // restore model space
-  glPopMatrix();
+  draw->pop();
 }
 
 
@@ -1165,11 +1612,11 @@ drawDIntr()
   int nY = (y < 0? 0: (y >= height? height - 1: y));
 
   // initial color and current position
-  glColor3fv(intrCol);
-  glBegin(GL_LINES);
-  glVertex2d(0, y);
-  glVertex2d(width, y);
-  glEnd();
+  draw->color(intrCol);
+  draw->begin(Draw::p_lines);
+  draw->vertex(0, y);
+  draw->vertex(width, y);
+  draw->end();
 
   char buf[256];
   snprintf(buf, sizeof(buf), "%g: %g", intrY, (y != nY? NAN: distribData[nY]));
@@ -1182,7 +1629,7 @@ drawValues()
 {
   const Value& last = graph->rrBuf[history - 1];
   char buf[256];
-  glColor3fv(textCol);
+  draw->color(textCol);
 
   snprintf(buf, sizeof(buf), "%g", loLimit);
   drawOSString(width, 0, buf);
@@ -1209,9 +1656,9 @@ drawGraphKey()
 
   if(values)
   {
-    for(size_t i = 0; i != graphs.size(); ++i)
+    for(size_t i = 0; i != shown.size(); ++i)
     {
-      snprintf(buf, sizeof(buf), ": %g", graphs[i].rrBuf[history - 1]);
+      snprintf(buf, sizeof(buf), ": %g", shown[i]->rrBuf[history - 1]);
       string str(buf);
       lines.push_back(str);
       if(str.size() > maxValue)
@@ -1227,44 +1674,45 @@ drawGraphKey()
   int textX2 = textX1 + maxLabel * fontWidth;
   int y = height - fontHeight * 2 - strSpc;
   int graphKeyX1 = textX1 - strSpc;
-  int graphKeyY1 = y - graphs.size() * fontHeight - strSpc;
+  int graphKeyY1 = y - shown.size() * fontHeight - strSpc;
   int graphKeyY2 = y + strSpc;
 
-  glColor4f(0., 0., 0., Trend::fillTextAlpha);
-  glBegin(GL_QUADS);
-  glVertex2i(width, graphKeyY1);
-  glVertex2i(graphKeyX1, graphKeyY1);
-  glVertex2i(graphKeyX1, graphKeyY2);
-  glVertex2i(width, graphKeyY2);
-  glEnd();
+  draw->color(0., 0., 0., Trend::fillTextAlpha);
+  draw->begin(Draw::p_quads);
+  draw->vertex(width, graphKeyY1);
+  draw->vertex(graphKeyX1, graphKeyY1);
+  draw->vertex(graphKeyX1, graphKeyY2);
+  draw->vertex(width, graphKeyY2);
+  draw->end();
 
-  for(size_t i = 0; i != graphs.size(); ++i, y -= fontHeight)
+  for(size_t i = 0; i != shown.size(); ++i, y -= fontHeight)
   {
-    const Graph& g(graphs[i]);
+    const Graph& g(*shown[i]);
 
-    glColor4f(g.lineCol[0], g.lineCol[1], g.lineCol[2],
+    draw->color(g.lineCol[0], g.lineCol[1], g.lineCol[2],
 	(&g == graph? 1.: Trend::fillTrendAlpha));
-    glBegin(GL_QUADS);
-    glVertex2i(width, y - fontHeight);
-    glVertex2i(boxX1, y - fontHeight);
-    glVertex2i(boxX1, y);
-    glVertex2i(width, y);
-    glEnd();
+    draw->begin(Draw::p_quads);
+    draw->vertex(width, y - fontHeight);
+    draw->vertex(boxX1, y - fontHeight);
+    draw->vertex(boxX1, y);
+    draw->vertex(width, y);
+    draw->end();
 
     if(&g == graph)
     {
-      glColor4f(g.lineCol[0], g.lineCol[1], g.lineCol[2], Trend::fillTrendAlpha);
-      glBegin(GL_QUADS);
-      glVertex2i(boxX1, y - fontHeight);
-      glVertex2i(textX1, y - fontHeight);
-      glVertex2i(textX1, y);
-      glVertex2i(boxX1, y);
-      glEnd();
+      draw->color(g.lineCol[0], g.lineCol[1], g.lineCol[2],
+	  Trend::fillTrendAlpha);
+      draw->begin(Draw::p_quads);
+      draw->vertex(boxX1, y - fontHeight);
+      draw->vertex(textX1, y - fontHeight);
+      draw->vertex(textX1, y);
+      draw->vertex(boxX1, y);
+      draw->end();
     }
 
-    glColor3f(textCol[0], textCol[1], textCol[2]);
-    drawString(textX1 + (maxLabel - graphs[i].label.size()) * fontWidth,
-	y - fontHeight + strSpc, graphs[i].label);
+    draw->color(textCol[0], textCol[1], textCol[2]);
+    drawString(textX1 + (maxLabel - g.label.size()) * fontWidth,
+	y - fontHeight + strSpc, g.label);
     if(values) drawString(textX2, y - fontHeight + strSpc, lines[i]);
   }
 }
@@ -1274,11 +1722,69 @@ void
 drawLatency()
 {
   char buf[256];
-  glColor3fv(textCol);
+  draw->color(textCol);
 
   snprintf(buf, sizeof(buf), "lat: %g/%g", vLat, bLat);
   drawLEString(buf);
-}
+
+  const Stats s = getStats();
+  snprintf(buf, sizeof(buf), "e2e: %.3f/%.3f/%.3fms", s.latP50 / 1e6,
+      s.latP99 / 1e6, s.latMax / 1e6);
+  drawLEString(buf);
+
+  snprintf(buf, sizeof(buf), "in: %lu ovr: %lu err: %lu blk: %.3fs",
+      static_cast<unsigned long>(s.samples),
+      static_cast<unsigned long>(s.overruns),
+      static_cast<unsigned long>(s.errors), s.blocked / 1e9);
+  if(sinkPath.size())
+  {
+    size_t len = strlen(buf);
+    snprintf(buf + len, sizeof(buf) - len, " drop: %lu",
+	static_cast<unsigned long>(s.dropped));
+  }
+  if(video)
+  {
+    size_t len = strlen(buf);
+    snprintf(buf + len, sizeof(buf) - len, " vid: %lu/%lu",
+	static_cast<unsigned long>(s.vidFrames),
+	static_cast<unsigned long>(s.vidDrops));
+  }
+  if(s.cmdDrops)
+  {
+    size_t len = strlen(buf);
+    snprintf(buf + len, sizeof(buf) - len, " cmd: %lu",
+	static_cast<unsigned long>(s.cmdDrops));
+  }
+  drawLEString(buf);
+}
+
+
+void
+drawProfile()
+{
+  // summarize the stages every latAvg seconds (at the end when headless)
+  const uint64_t now = monotonic();
+  if(!headless && now - profLast >= Trend::latAvg * 1000000000ULL)
+  {
+    for(size_t i = 0; i != Profile::stages; ++i)
+      profSums[i] = profile.take(static_cast<Profile::stage_t>(i));
+    profLast = now;
+  }
+
+  char buf[256];
+  draw->color(textCol);
+
+  for(size_t i = Profile::stages; i--;)
+  {
+    const Histogram::Summary& s = profSums[i];
+    snprintf(buf, sizeof(buf), "%-8s %8lu %9.1f %9.1f %9.1f",
+	Profile::name(static_cast<Profile::stage_t>(i)),
+	static_cast<unsigned long>(s.count), s.p50 / 1e3, s.p99 / 1e3,
+	s.max / 1e3);
+    drawLEString(buf);
+  }
+  drawLEString("stage           n   p50(us)   p99(us)   max(us)");
+}
 
 
 void
@@ -1305,27 +1811,27 @@ drawFrame(const GLfloat* color, const string& str)
   const int blockH = blockB + fontHeight + fontHeight / 2;
   const int blockS = fontHeight / 2;
 
-  glBegin(GL_QUADS);
+  draw->begin(Draw::p_quads);
 
   // background
-  glColor4f(0., 0., 0., Trend::fillTextAlpha);
-  glVertex2d(0, height2 + blockH);
-  glVertex2d(width, height2 + blockH);
-  glVertex2d(width, height2 - blockH);
-  glVertex2d(0, height2 - blockH);
+  draw->color(0., 0., 0., Trend::fillTextAlpha);
+  draw->vertex(0, height2 + blockH);
+  draw->vertex(width, height2 + blockH);
+  draw->vertex(width, height2 - blockH);
+  draw->vertex(0, height2 - blockH);
 
   // borders
-  glColor3fv(color);
-  glVertex2d(0, height2 + blockH + blockS);
-  glVertex2d(width, height2 + blockH + blockS);
-  glVertex2d(width, height2 + blockH);
-  glVertex2d(0, height2 + blockH);
-  glVertex2d(0, height2 - blockH - blockS);
-  glVertex2d(width, height2 - blockH - blockS);
-  glVertex2d(width, height2 - blockH);
-  glVertex2d(0, height2 - blockH);
-
-  glEnd();
+  draw->color(color);
+  draw->vertex(0, height2 + blockH + blockS);
+  draw->vertex(width, height2 + blockH + blockS);
+  draw->vertex(width, height2 + blockH);
+  draw->vertex(0, height2 + blockH);
+  draw->vertex(0, height2 - blockH - blockS);
+  draw->vertex(width, height2 - blockH - blockS);
+  draw->vertex(width, height2 - blockH);
+  draw->vertex(0, height2 - blockH);
+
+  draw->end();
 
   // strings
   int x = width2 - fontWidth * max / 2;
@@ -1339,10 +1845,10 @@ drawFrame(const GLfloat* color, const string& str)
     else
     {
       int y = height2 + blockB - fontHeight * i - fontHeight / 2;
-      glBegin(GL_LINES);
-      glVertex2i(0, y);
-      glVertex2i(width, y);
-      glEnd();
+      draw->begin(Draw::p_lines);
+      draw->vertex(0, y);
+      draw->vertex(width, y);
+      draw->end();
     }
   }
 }
@@ -1364,17 +1870,17 @@ drawMessages()
   const int width2 = width / 2;
 
   int ty = height - fontHeight * messages.size() - strSpc * 4;
-  glColor4f(0., 0., 0., Trend::fillTextAlpha);
-  glBegin(GL_QUADS);
-  glVertex2d(0, ty);
-  glVertex2d(width, ty);
-  glVertex2d(width, height);
-  glVertex2d(0, height);
-  glEnd();
+  draw->color(0., 0., 0., Trend::fillTextAlpha);
+  draw->begin(Draw::p_quads);
+  draw->vertex(0, ty);
+  draw->vertex(width, ty);
+  draw->vertex(width, height);
+  draw->vertex(0, height);
+  draw->end();
 
   // draw messages
   int y = height - strSpc - fontHeight;
-  glColor3fv(editCol);
+  draw->color(editCol);
 
   for(deque<pair<time_t, string> >::const_iterator it = messages.begin();
       it != messages.end(); ++it, y -= fontHeight)
@@ -1385,54 +1891,177 @@ drawMessages()
 }
 
 
-// redraw handler
+// account the drawing time and input to display latency of a swapped frame
 void
-display()
+updateTimes(uint64_t begin)
 {
-  // reset some data
-  lc = 0;
+  const uint64_t now = monotonic();
+  atFrame.record(now - begin);
+  __atomic_add_fetch(&stats.frames, 1, __ATOMIC_RELAXED);
+  if(frameStamp)
+  {
+    atELat.record(now - frameStamp);
+    frameStamp = 0;
+  }
+
+  // publish the percentiles of the last period
+  if(now - timesLast >= Trend::latAvg * 1000000000ULL)
+  {
+    Histogram::Summary s = atELat.take();
+    __atomic_store_n(&stats.latP50, s.p50, __ATOMIC_RELAXED);
+    __atomic_store_n(&stats.latP99, s.p99, __ATOMIC_RELAXED);
+    __atomic_store_n(&stats.latMax, s.max, __ATOMIC_RELAXED);
+
+    s = atFrame.take();
+    __atomic_store_n(&stats.frameP50, s.p50, __ATOMIC_RELAXED);
+    __atomic_store_n(&stats.frameP99, s.p99, __ATOMIC_RELAXED);
+    __atomic_store_n(&stats.frameMax, s.max, __ATOMIC_RELAXED);
+    timesLast = now;
+  }
+}
+
+
+// queue the current frame for the video output
+void
+captureFrame()
+{
+  if(!soft)
+    video->capture(winWidth, winHeight);
+  else if(unsigned char* buf = video->reserve(winWidth, winHeight))
+  {
+    soft->read(buf);
+    video->commit();
+  }
+}
 
+
+// draw the current pane, returning the last stage time
+uint64_t
+displayPane(uint64_t t)
+{
   // setup model coordinates
   double zero = (distrib?
       -(static_cast<double>(Trend::distribWidth) * divisions /
 	  (width - Trend::distribWidth)): 0);
 
-  glClear(GL_COLOR_BUFFER_BIT);
-  glLoadIdentity();
-  gluOrtho2D(zero, divisions, loLimit, hiLimit);
+  lc = 0;
+  if(spectrum)
+  {
+    // instead of the graphs
+    drawSpectrum();
+    t = profile.lap(Profile::s_lines, t);
+    if(graphKey) drawGraphKey();
+    return profile.lap(Profile::s_text, t);
+  }
+
+  draw->ortho(zero, divisions, loLimit, hiLimit);
 
   // background grid and main data
   if(grid) drawGrid();
-  if(filled) drawFill(*graph);
+  t = profile.lap(Profile::s_grid, t);
+  if(marks.size()) drawMarks();
+  t = profile.lap(Profile::s_marks, t);
+  if(filled && view != Trend::v_heatmap) drawFill(*graph);
   if(showUndef) drawFillUndef(*graph);
+  t = profile.lap(Profile::s_fill, t);
 
   // graphs
-  if(view != Trend::v_hide)
+  size_t pos;
+  if(view == Trend::v_heatmap)
+    pos = drawHeatmap();
+  else
   {
-    double alphaMul = (view == Trend::v_dim? Trend::drawOthersAlpha: 1.);
-    for(vector<Graph>::iterator gi = graphs.begin(); gi != graphs.end(); ++gi)
-      if(&*gi != graph)
-	drawLine(*gi, alphaMul);
+    if(view != Trend::v_hide)
+    {
+      double alphaMul = (view == Trend::v_dim? Trend::drawOthersAlpha: 1.);
+      for(vector<Graph*>::iterator gi = shown.begin(); gi != shown.end(); ++gi)
+	if(*gi != graph)
+	  drawLine(**gi, alphaMul);
+    }
+    pos = drawLine(*graph, 1.);
   }
-  size_t pos = drawLine(*graph, 1.);
+  t = profile.lap(Profile::s_lines, t);
 
   // other data
   if(distrib) drawDistrib();
+  t = profile.lap(Profile::s_distrib, t);
   if(marker && !scroll) drawMarker(pos);
   if(intr && (!distrib || intrX >= 0))
     drawTIntr();
 
   // setup video coordinates
-  glLoadIdentity();
-  gluOrtho2D(0, width, 0, height);
+  draw->ortho(0, width, 0, height);
 
   // video stuff
   if(values) drawValues();
   if(graphKey) drawGraphKey();
-  if(latency) drawLatency();
   if(intr && distrib && intrX < 0)
     drawDIntr();
 
+  return profile.lap(Profile::s_text, t);
+}
+
+
+// pane separators, with the current pane outlined
+void
+drawPanes()
+{
+  draw->color(textCol);
+  draw->begin(Draw::p_lines);
+  for(size_t i = 1; i < panes.size(); ++i)
+  {
+    int y = panes[i].y + panes[i].height;
+    draw->vertex(0, y);
+    draw->vertex(width, y);
+  }
+  draw->end();
+
+  const Pane& p = panes[pane];
+  draw->color(markCol[0], markCol[1], markCol[2], 0.5);
+  draw->begin(Draw::p_lineLoop);
+  draw->vertex(p.x + 0.5, p.y + 0.5);
+  draw->vertex(p.x + p.width - 0.5, p.y + 0.5);
+  draw->vertex(p.x + p.width - 0.5, p.y + p.height - 0.5);
+  draw->vertex(p.x + 0.5, p.y + p.height - 0.5);
+  draw->end();
+}
+
+
+// redraw handler
+void
+display()
+{
+  // reset some data
+  const uint64_t begin = monotonic();
+
+  // stage timings (drawing is timed on submission)
+  profile.enable(profiling || headless);
+  const uint64_t start = profile.start();
+  uint64_t t = start;
+
+  draw->viewport(0, 0, winWidth, winHeight);
+  draw->clear();
+  t = profile.lap(Profile::s_clear, t);
+
+  // each pane in its own viewport (text lines continue from the bottom one)
+  const size_t focus = pane;
+  for(size_t i = 0; i != panes.size(); ++i)
+  {
+    selectPane(i);
+    draw->viewport(panes[i].x, panes[i].y, width, height);
+    t = displayPane(t);
+  }
+  selectPane(focus);
+
+  // window overlays
+  width = winWidth;
+  height = winHeight;
+  draw->viewport(0, 0, width, height);
+  draw->ortho(0, width, 0, height);
+  if(panes.size() > 1) drawPanes();
+  if(latency) drawLatency();
+  if(profiling) drawProfile();
+
   // modes
   if(messages.size()) drawMessages();
   if(mode == Trend::m_editing)
@@ -1440,34 +2069,46 @@ display()
   else if(mode == Trend::m_message)
     drawFrame(Trend::helpCol, messageStr);
 
-  // flush buffers
-  glutSwapBuffers();
+  t = profile.lap(Profile::s_text, t);
+  selectPane(focus);
+
+  // queue the frame for export before the swap
+  if(video) captureFrame();
+
+  // flush buffers (snapshots are read back asynchronously)
+  if(!headless)
+    glutSwapBuffers();
+  else
+    draw->finish(benchFrames);
+  profile.lap(Profile::s_swap, t);
+  profile.lap(Profile::s_frame, start);
   atVLat.stop();
   vLat = atVLat.avg();
+  updateTimes(begin);
 }
 
 
 void
-setGraphLimits(const Graph& g, Value& lo, Value& hi)
+setGraphLimits(Graph& g, Value& lo, Value& hi)
 {
-  for(const Value* it = g.rrBuf; it != g.rrEnd; ++it)
+  // the range is scanned at most once per update, whatever the panes
+  if(!g.ranged)
   {
-    if(isfinite(*it))
-    {
-      if(!isfinite(lo) || *it < lo)
-	lo = *it;
-      if(!isfinite(hi) || *it > hi)
-	hi = *it;
-    }
+    g.lo = g.hi = NAN;
+    valueRange(g.rrBuf, g.rrEnd, g.lo, g.hi);
+    g.ranged = true;
   }
+
+  const Value range[2] = {g.lo, g.hi};
+  valueRange(range, range + 2, lo, hi);
 }
 
 
 void
 setLimits()
 {
-  Value lo = *graph->rrBuf;
-  Value hi = lo;
+  Value lo = NAN;
+  Value hi = NAN;
 
   if(view == Trend::v_hide)
   {
@@ -1476,8 +2117,8 @@ setLimits()
   }
   else
   {
-    for(vector<Graph>::iterator it = graphs.begin(); it != graphs.end(); ++it)
-      setGraphLimits(*it, lo, hi);
+    for(vector<Graph*>::iterator it = shown.begin(); it != shown.end(); ++it)
+      setGraphLimits(**it, lo, hi);
   }
 
   // some vertical bounds
@@ -1486,38 +2127,218 @@ setLimits()
 }
 
 
+// request a redraw (headless loops draw when dirty, if at all)
+void
+redraw()
+{
+  if(!headless)
+    glutPostRedisplay();
+  else
+    dirty = true;
+}
+
+
+// pass the new values of the current graph to the analyzer (all of them for
+// a different graph), returning true when new results are available
+bool
+updateSpectrum(bool fed)
+{
+  if(!spectrum)
+  {
+    specGraph = NULL;
+    return false;
+  }
+
+  if(!analyzer)
+  {
+    analyzer = new Spectrum(specSize, specAverage, history);
+    if(!analyzer->open())
+    {
+      delete analyzer;
+      analyzer = NULL;
+      spectrum = false;
+      pushMessage("cannot start the spectrum analysis");
+      return true;
+    }
+  }
+
+  if(specGraph != graph)
+  {
+    analyzer->reset();
+    specGraph = graph;
+    fed = true;
+  }
+  if(fed)
+  {
+    analyzer->feed(graph->rrEnd, graph->rrPos, history);
+    if(lockstep) analyzer->sync();
+  }
+
+  return analyzer->fetch(specAvg, specPeak);
+}
+
+
 void
 check()
 {
   // check if a redraw is really necessary
   bool recalc = false;
+  vector<pair<size_t, string> > names;
 
   pthread_mutex_lock(&mutex);
   if(damaged)
   {
-    damaged = false;
+    // in lockstep, the producer is released after the copy
+    damaged = lockstep;
     atBLat.stop();
     bLat = atBLat.avg();
     recalc = true;
+
+    // oldest data included in the next frame
+    if(!frameStamp) frameStamp = syncStamp;
   }
+  if(relabels.size())
+    names.swap(relabels);
   pthread_mutex_unlock(&mutex);
 
+  // graphs claimed by new series
+  for(vector<pair<size_t, string> >::iterator it = names.begin();
+      it != names.end(); ++it)
+  {
+    graphs[it->first].label = it->second;
+    if(it->second.size() > maxLabel)
+      maxLabel = it->second.size();
+  }
+
   if(recalc)
   {
     atVLat.start();
 
-    // update buffers
+    // update buffers, accounting for values never displayed
+    uint64_t t = profile.start();
+    size_t lost = 0;
     for(vector<Graph>::iterator gi = graphs.begin(); gi != graphs.end(); ++gi)
     {
-      gi->rrPos = gi->rrData->copy(gi->rrBuf);
+      size_t pos = gi->rrData->copy(gi->rrBuf);
+      if(pos - gi->rrPos > history)
+	lost += pos - gi->rrPos - history;
+      gi->rrPos = pos;
+      gi->ranged = false;
       if(gi->zero) rrShift(*gi, gi->zero);
     }
+    if(lost) __atomic_add_fetch(&stats.overruns, lost, __ATOMIC_RELAXED);
+    t = profile.lap(Profile::s_copy, t);
+
+    if(lockstep)
+    {
+      pthread_mutex_lock(&mutex);
+      damaged = false;
+      pthread_cond_broadcast(&synced);
+      pthread_mutex_unlock(&mutex);
+    }
 
     // recalculate limits seldom
-    if(autoLimit) setLimits();
+    const size_t focus = pane;
+    for(size_t i = 0; i != panes.size(); ++i)
+    {
+      selectPane(i);
+      if(autoLimit) setLimits();
+    }
+    selectPane(focus);
+    profile.lap(Profile::s_limits, t);
 
-    glutPostRedisplay();
+    redraw();
+  }
+
+  // spectra are updated asynchronously, in the panes showing them
+  bool analyzed = false;
+  const size_t focus = pane;
+  for(size_t i = 0; i != panes.size(); ++i)
+  {
+    if(i != pane && !panes[i].spectrum) continue;
+    selectPane(i);
+    if(updateSpectrum(recalc)) analyzed = true;
+  }
+  selectPane(focus);
+  if(analyzed) redraw();
+}
+
+
+void
+remote(const Command& cmd);
+
+
+// apply all the pending escape/control commands in a single batch
+void
+execute()
+{
+  Command cmd;
+  if(!commands.pop(cmd)) return;
+
+  do
+  {
+    switch(cmd.code)
+    {
+    case Trend::c_limits:
+      autoLimit = false;
+      loLimit = cmd.args[0];
+      hiLimit = cmd.args[1];
+      break;
+
+    case Trend::c_autolim:
+      autoLimit = (cmd.args[0] != 0.);
+      if(autoLimit) setLimits();
+      break;
+
+    case Trend::c_zero:
+      {
+	Graph& g = graphs[cmd.graph];
+	if(cmd.args[0] != g.zero)
+	{
+	  rrShift(g, cmd.args[0] - g.zero);
+	  g.zero = cmd.args[0];
+	  ++zeroSerial;
+	  if(autoLimit) setLimits();
+	}
+      }
+      break;
+
+    case Trend::c_pause:
+      paused = (cmd.args[0] != 0.);
+      break;
+
+    case Trend::c_mark:
+      marks.push_back(pair<size_t, size_t>(cmd.graph, cmd.pos));
+      if(marks.size() > static_cast<size_t>(Trend::maxMarks))
+	marks.pop_front();
+      break;
+
+    case Trend::c_graph:
+      {
+	// in all the panes showing it
+	Graph* g = &graphs[cmd.graph];
+	const size_t focus = pane;
+	for(size_t i = 0; i != panes.size(); ++i)
+	{
+	  selectPane(i);
+	  if(std::find(shown.begin(), shown.end(), g) == shown.end())
+	    continue;
+	  graph = g;
+	  if(autoLimit && view == Trend::v_hide)
+	    setLimits();
+	}
+	selectPane(focus);
+      }
+      break;
+
+    case Trend::c_control:
+      remote(cmd);
+      break;
+    }
   }
+  while(commands.pop(cmd));
+
+  redraw();
 }
 
 
@@ -1526,6 +2347,7 @@ idle(int = 0)
 {
   // re-register the callback
   glutTimerFunc(pollMs, idle, 0);
+  execute();
 
   // consume messages when paused
   if(paused)
@@ -1720,6 +2542,7 @@ getZero(const string& str)
   {
     rrShift(*graph, nZero - graph->zero);
     graph->zero = nZero;
+    ++zeroSerial;
     if(autoLimit) setLimits();
   }
 }
@@ -1743,8 +2566,8 @@ getPollRate(const string& str)
 void
 changeGraph()
 {
-  if(++graph == &*graphs.end())
-    graph = &graphs[0];
+  vector<Graph*>::iterator it = std::find(shown.begin(), shown.end(), graph);
+  graph = (++it == shown.end()? shown.front(): *it);
   if(!graphKey && !values)
     pushMessage(string("current graph: ") + graph->label);
   if(autoLimit && view == Trend::v_hide)
@@ -1752,6 +2575,17 @@ changeGraph()
 }
 
 
+void
+changePane()
+{
+  selectPane((pane + 1) % panes.size());
+  char buf[64];
+  snprintf(buf, sizeof(buf), "current pane: %lu",
+      static_cast<unsigned long>(pane + 1));
+  pushMessage(buf);
+}
+
+
 void
 toggleView()
 {
@@ -1769,8 +2603,13 @@ toggleView()
     break;
 
   case Trend::v_hide:
-    view = Trend::v_normal;
+    view = Trend::v_heatmap;
     if(autoLimit) setLimits();
+    pushMessage("view mode: heatmap");
+    break;
+
+  case Trend::v_heatmap:
+    view = Trend::v_normal;
     pushMessage("view mode: normal");
     break;
   }
@@ -1791,6 +2630,10 @@ dispKeyboard(const unsigned char key, const int x, const int y)
     changeGraph();
     break;
 
+  case Trend::paneKey:
+    changePane();
+    break;
+
   case Trend::dimmedKey:
     toggleStatus("dimmed", dimmed);
     break;
@@ -1805,6 +2648,15 @@ dispKeyboard(const unsigned char key, const int x, const int y)
     toggleStatus("distribution", distrib);
     break;
 
+  case Trend::spectrumKey:
+    toggleStatus("spectrum", spectrum);
+    break;
+
+  case Trend::peakHoldKey:
+    toggleStatus("peak-hold", peakHold);
+    if(analyzer) analyzer->resetPeaks();
+    break;
+
   case Trend::autolimKey:
     toggleStatus("autolimit", autoLimit);
     break;
@@ -1869,6 +2721,10 @@ dispKeyboard(const unsigned char key, const int x, const int y)
     toggleStatus("latency", latency);
     break;
 
+  case Trend::profKey:
+    toggleStatus("profiling", profiling);
+    break;
+
   case Trend::pollRateKey:
     editMode("poll rate", getPollRate);
     break;
@@ -1893,7 +2749,9 @@ dispKeyboard(const unsigned char key, const int x, const int y)
 void
 dispMotion(int x, int y)
 {
-  unproject(x, y, intrX, intrY);
+  // relative to the current pane
+  const Pane& p = panes[pane];
+  unproject(x - p.x, y - (winHeight - p.y - p.height), intrX, intrY);
   glutPostRedisplay();
 }
 
@@ -1901,6 +2759,14 @@ dispMotion(int x, int y)
 void
 dispMouse(int button, int state, int x, int y)
 {
+  // the pane under the pointer becomes current
+  for(size_t i = 0; i != panes.size(); ++i)
+  {
+    const Pane& p = panes[i];
+    if(winHeight - y > p.y && winHeight - y <= p.y + p.height)
+      selectPane(i);
+  }
+
   // cause a motion event internally
   intr = (button != GLUT_RIGHT_BUTTON);
   intrFg = (glutGetModifiers() & GLUT_ACTIVE_CTRL);
@@ -1909,106 +2775,537 @@ dispMouse(int button, int state, int x, int y)
 
 
 /*
- * CLI and options
+ * Remote control
  */
 
-// Parse a hist/n, div*n, div spec
+// Set a status from on/off (or toggle it)
 bool
-parseHistSpec(size_t& hist, size_t& div, const char* spec)
+parseStatus(bool& var, const string& str)
 {
-  // find the separator first.
-  // TODO: * is deprecated
-  const char* p = strpbrk(spec, "/*x");
-  if((p == spec) || (p && *(p + 1) == 0))
-    return true;
-
-  if(!p)
-  {
-    div = strtoul(spec, NULL, 0);
-    hist = div + 1;
-    return false;
-  }
-  else if(*p == '/')
-  {
-    hist = strtoul(spec, NULL, 0);
-    div = strtoul(p + 1, NULL, 0);
-    if(!div) return true;
-    div = hist / div;
-  }
+  if(str.empty() || str == "toggle")
+    var = !var;
+  else if(str == "on" || str == "1")
+    var = true;
+  else if(str == "off" || str == "0")
+    var = false;
   else
-  {
-    div = strtoul(spec, NULL, 0);
-    hist = div * strtoul(p + 1, NULL, 0);
-  }
+    return true;
 
   return false;
 }
 
 
-size_t
-parseInput(Trend::input_t& input, const char* arg)
+// finite limits in increasing order
+bool
+validLimits(double lo, double hi)
 {
-  char* end;
-  size_t n = strtoul(arg, &end, 10);
-  if(end == arg) n = 1;
-
-  switch(*end)
-  {
-  case 'a': input = Trend::absolute; break;
-  case 'i': input = Trend::incremental; break;
-  case 'd': input = Trend::differential; break;
+  return isfinite(lo) && isfinite(hi) && lo < hi;
+}
 
-  default:
-    return 0;
-  };
 
-  return n;
+// parse "lo hi", both required
+bool
+parseLimits(const char* str, double& lo, double& hi)
+{
+  char* p;
+  char* end;
+  lo = strtod(str, &p);
+  hi = strtod(p, &end);
+  if(p == str || end == p) return false;
+  while(isspace(static_cast<unsigned char>(*end))) ++end;
+  return !*end && validLimits(lo, hi);
 }
 
 
 bool
-parseFormat(Trend::format_t& format, const char* arg)
+checkLimits(const char* str)
 {
-  switch(arg[0])
-  {
-  case 'a': format = Trend::f_ascii; break;
-  case 'f': format = Trend::f_float; break;
-  case 'd': format = Trend::f_double; break;
-  case 's': format = Trend::f_short; break;
-  case 'i': format = Trend::f_int; break;
-  case 'l': format = Trend::f_long; break;
+  double lo, hi;
+  return parseLimits(str, lo, hi);
+}
 
-  default:
-    return true;
-  };
 
-  return false;
+void
+remoteLimits(const string& str)
+{
+  double lo, hi;
+  if(!parseLimits(str.c_str(), lo, hi)) return;
+  autoLimit = false;
+  loLimit = lo;
+  hiLimit = hi;
 }
 
 
+// parse "center [amplitude]", amp2 being half the amplitude (or NaN)
 bool
-parseNums(vector<double>& nums, char* arg)
+parseCenter(const char* str, double& c, double& amp2)
 {
   char* p;
-  while((p = strsep(&arg, ",")))
-    nums.push_back(strtod(p, NULL));
-  return false;
+  char* end;
+  c = strtod(str, &p);
+  if(p == str || !isfinite(c)) return false;
+  amp2 = strtod(p, &end) / 2;
+  if(end == p) amp2 = NAN;
+  else if(!isfinite(amp2) || amp2 <= 0) return false;
+  while(isspace(static_cast<unsigned char>(*end))) ++end;
+  return !*end;
 }
 
 
 bool
-parseStrings(vector<string>& strings, char* arg)
+checkCenter(const char* str)
 {
-  char* p;
-  while((p = strsep(&arg, ",")))
-    strings.push_back(p);
-  return false;
+  double c, amp2;
+  return parseCenter(str, c, amp2);
 }
 
 
-// Initialize globals through command line
-int
-parseOptions(int argc, char* const argv[])
+void
+remoteCenterAmp(const string& str)
+{
+  double c, amp2;
+  if(!parseCenter(str.c_str(), c, amp2)) return;
+  if(isnan(amp2)) amp2 = (hiLimit - loLimit) / 2;
+  if(!validLimits(c - amp2, c + amp2)) return;
+  autoLimit = false;
+  loLimit = c - amp2;
+  hiLimit = c + amp2;
+}
+
+
+void
+remoteResetLimits(const string&)
+{
+  setLimits();
+}
+
+
+void
+remoteView(const string& str)
+{
+  if(str.empty())
+  {
+    toggleView();
+    return;
+  }
+
+  if(str == "normal") view = Trend::v_normal;
+  else if(str == "dim") view = Trend::v_dim;
+  else if(str == "hide") view = Trend::v_hide;
+  else if(str == "heatmap") view = Trend::v_heatmap;
+  else return;
+
+  if(autoLimit) setLimits();
+}
+
+
+void
+remoteGraph(const string& str)
+{
+  if(str.empty())
+  {
+    changeGraph();
+    return;
+  }
+
+  // by label first, then by number
+  vector<Graph>::iterator it = graphs.begin();
+  while(it != graphs.end() && it->label != str) ++it;
+  if(it == graphs.end())
+  {
+    size_t n = strtoul(str.c_str(), NULL, 0);
+    if(n < 1 || n > graphs.size()) return;
+    it = graphs.begin() + (n - 1);
+  }
+
+  // only among the graphs of the current pane
+  if(std::find(shown.begin(), shown.end(), &*it) == shown.end()) return;
+  graph = &*it;
+  if(autoLimit && view == Trend::v_hide)
+    setLimits();
+}
+
+
+void
+remotePane(const string& str)
+{
+  if(str.empty())
+  {
+    changePane();
+    return;
+  }
+
+  size_t n = strtoul(str.c_str(), NULL, 0);
+  if(n >= 1 && n <= panes.size())
+    selectPane(n - 1);
+}
+
+
+void
+remoteSmooth(const string&)
+{
+  init();
+}
+
+
+void
+remotePeakHold(const string&)
+{
+  if(analyzer) analyzer->resetPeaks();
+}
+
+
+void
+remoteQuit(const string&)
+{
+  exit(Trend::success);
+}
+
+
+// Commands: the name, the status to change and/or the edit callback
+struct Remote
+{
+  const char* name;
+  bool* status;
+  edit_callback_t call;
+  bool (*check)(const char* str);	// argument validation (producer side)
+};
+
+const Remote remotes[] =
+{
+  {"limits", NULL, remoteLimits, checkLimits},
+  {"center", NULL, remoteCenterAmp, checkCenter},
+  {"reset-limits", NULL, remoteResetLimits, NULL},
+  {"grid-spec", NULL, getGrid, NULL},
+  {"zero", NULL, getZero, NULL},
+  {"poll-rate", NULL, getPollRate, NULL},
+  {"view", NULL, remoteView, NULL},
+  {"graph", NULL, remoteGraph, NULL},
+  {"pane", NULL, remotePane, NULL},
+  {"quit", NULL, remoteQuit, NULL},
+  {"pause", &paused, NULL, NULL},
+  {"autolimit", &autoLimit, NULL, NULL},
+  {"dimmed", &dimmed, NULL, NULL},
+  {"distribution", &distrib, NULL, NULL},
+  {"spectrum", &spectrum, NULL, NULL},
+  {"peak-hold", &peakHold, remotePeakHold, NULL},
+  {"smoothing", &smooth, remoteSmooth, NULL},
+  {"scrolling", &scroll, NULL, NULL},
+  {"values", &values, NULL, NULL},
+  {"marker", &marker, NULL, NULL},
+  {"fill", &filled, NULL, NULL},
+  {"show-undefined", &showUndef, NULL, NULL},
+  {"graph-key", &graphKey, NULL, NULL},
+  {"grid", &grid, NULL, NULL},
+  {"latency", &latency, NULL, NULL},
+  {"profiling", &profiling, NULL, NULL},
+};
+
+
+// queue a remote control line (from the producer thread)
+void
+control(const char* line, size_t len, string& reply)
+{
+  // split "name [argument]", ignoring surrounding blanks and comments
+  const char* end = line + len;
+  while(line != end && isspace(static_cast<unsigned char>(*line))) ++line;
+  while(end != line && isspace(static_cast<unsigned char>(end[-1]))) --end;
+  if(line == end || *line == '#') return;
+
+  const char* arg = line;
+  while(arg != end && !isspace(static_cast<unsigned char>(*arg))) ++arg;
+  size_t n = arg - line;
+  while(arg != end && isspace(static_cast<unsigned char>(*arg))) ++arg;
+
+  // queries are answered directly
+  if(n == 5 && !memcmp(line, "stats", 5))
+  {
+    char buf[256];
+    const Stats s = getStats();
+    snprintf(buf, sizeof(buf),
+	"samples=%lu overruns=%lu errors=%lu blocked=%.9f dropped=%lu "
+	"latency_p50=%.9f latency_p99=%.9f latency_max=%.9f "
+	"video_frames=%lu video_dropped=%lu commands_dropped=%lu\n",
+	static_cast<unsigned long>(s.samples),
+	static_cast<unsigned long>(s.overruns),
+	static_cast<unsigned long>(s.errors), s.blocked / 1e9,
+	static_cast<unsigned long>(s.dropped), s.latP50 / 1e9,
+	s.latP99 / 1e9, s.latMax / 1e9,
+	static_cast<unsigned long>(s.vidFrames),
+	static_cast<unsigned long>(s.vidDrops),
+	static_cast<unsigned long>(s.cmdDrops));
+    reply = buf;
+    return;
+  }
+
+  Command cmd;
+  if(static_cast<size_t>(end - arg) >= sizeof(cmd.str))
+    return;
+
+  // unknown commands are ignored
+  for(size_t i = 0; i != sizeof(remotes) / sizeof(*remotes); ++i)
+  {
+    if(strlen(remotes[i].name) != n || memcmp(remotes[i].name, line, n))
+      continue;
+
+    cmd.code = Trend::c_control;
+    cmd.op = i;
+    memcpy(cmd.str, arg, end - arg);
+    cmd.str[end - arg] = 0;
+    if(remotes[i].check && !remotes[i].check(cmd.str))
+      reply = "error: bad argument\n";
+    else if(!command(cmd))
+      reply = "error: command queue full\n";
+    break;
+  }
+}
+
+
+// apply a remote control command (from the display thread)
+void
+remote(const Command& cmd)
+{
+  const Remote& r = remotes[cmd.op];
+  if(r.status && parseStatus(*r.status, cmd.str))
+    return;
+  if(r.call)
+    (*r.call)(cmd.str);
+}
+
+
+/*
+ * CLI and options
+ */
+
+// Parse a hist/n, div*n, div spec
+bool
+parseHistSpec(size_t& hist, size_t& div, const char* spec)
+{
+  // find the separator first.
+  // TODO: * is deprecated
+  const char* p = strpbrk(spec, "/*x");
+  if((p == spec) || (p && *(p + 1) == 0))
+    return true;
+
+  if(!p)
+  {
+    div = strtoul(spec, NULL, 0);
+    hist = div + 1;
+    return false;
+  }
+  else if(*p == '/')
+  {
+    hist = strtoul(spec, NULL, 0);
+    div = strtoul(p + 1, NULL, 0);
+    if(!div) return true;
+    div = hist / div;
+  }
+  else
+  {
+    div = strtoul(spec, NULL, 0);
+    hist = div * strtoul(p + 1, NULL, 0);
+  }
+
+  return false;
+}
+
+
+size_t
+parseInput(Trend::input_t& input, const char* arg)
+{
+  char* end;
+  size_t n = strtoul(arg, &end, 10);
+  if(end == arg) n = 1;
+
+  switch(*end)
+  {
+  case 'a': input = Trend::absolute; break;
+  case 'i': input = Trend::incremental; break;
+  case 'd': input = Trend::differential; break;
+
+  default:
+    return 0;
+  };
+
+  return n;
+}
+
+
+// Parse a source spec ([[N]mode:]name), returning true when valid
+bool
+parseSource(Input& in, const char* spec)
+{
+  in.name = spec;
+  in.count = 0;
+
+  const char* p = strchr(spec, ':');
+  if(!p || p == spec)
+    return true;
+
+  // the prefix must be a valid input mode
+  string pre(spec, p - spec);
+  if(strspn(pre.c_str(), "0123456789") + 1 != pre.size())
+    return true;
+  if(!(in.count = parseInput(in.input, pre.c_str())))
+    return true;
+
+  in.name = p + 1;
+  return !in.name.empty();
+}
+
+
+// Parse a sink spec (file[@N])
+void
+parseSink(string& path, size_t& decimate, const char* spec)
+{
+  path = spec;
+  string::size_type p = path.rfind('@');
+  if(p == string::npos || p + 1 == path.size() ||
+      strspn(path.c_str() + p + 1, "0123456789") != path.size() - p - 1)
+    return;
+
+  decimate = strtoul(path.c_str() + p + 1, NULL, 10);
+  path.erase(p);
+}
+
+
+bool
+parseFormat(Trend::format_t& format, const char* arg)
+{
+  switch(arg[0])
+  {
+  case 'a': format = Trend::f_ascii; break;
+  case 'f': format = Trend::f_float; break;
+  case 'd': format = Trend::f_double; break;
+  case 's': format = Trend::f_short; break;
+  case 'i': format = Trend::f_int; break;
+  case 'l': format = Trend::f_long; break;
+  case 'n': format = Trend::f_named; break;
+
+  default:
+    return true;
+  };
+
+  return false;
+}
+
+
+bool
+parseNums(vector<double>& nums, char* arg)
+{
+  char* p;
+  while((p = strsep(&arg, ",")))
+    nums.push_back(strtod(p, NULL));
+  return false;
+}
+
+
+bool
+parseStrings(vector<string>& strings, char* arg)
+{
+  char* p;
+  while((p = strsep(&arg, ",")))
+    strings.push_back(p);
+  return false;
+}
+
+
+// Parse a spectrum spec: the number of values (a power of 2, at least 4)
+// optionally followed by the number of frames to average (size[,average])
+bool
+parseSpectrum(size_t& size, size_t& average, const char* spec)
+{
+  char* end;
+  size = strtoul(spec, &end, 0);
+  if(end == spec || size < 4 || (size & (size - 1)))
+    return true;
+
+  if(*end == ',')
+  {
+    spec = end + 1;
+    average = strtoul(spec, &end, 0);
+    if(end == spec || !average) return true;
+  }
+
+  return (*end != 0);
+}
+
+
+// Parse a pane spec: graph numbers or ranges separated by commas, optionally
+// followed by fixed limits (N[-M][,...][:low:high])
+bool
+parsePane(Pane& p, const char* spec)
+{
+  p.shown.clear();
+  char* end;
+  for(;;)
+  {
+    size_t first = strtoul(spec, &end, 10);
+    size_t last = first;
+    if(end == spec) return true;
+    if(*end == '-')
+    {
+      spec = end + 1;
+      last = strtoul(spec, &end, 10);
+      if(end == spec) return true;
+    }
+    if(!first || first > last || last > graphs.size())
+      return true;
+
+    for(size_t i = first; i <= last; ++i)
+      p.shown.push_back(&graphs[i - 1]);
+    if(*end != ',') break;
+    spec = end + 1;
+  }
+
+  if(*end == ':')
+  {
+    p.loLimit = strtod(end + 1, &end);
+    if(*end != ':') return true;
+    p.hiLimit = strtod(end + 1, &end);
+    p.autoLimit = false;
+  }
+  if(*end) return true;
+
+  p.graph = p.shown.front();
+  return false;
+}
+
+
+// Create the panes from their specs (a single pane showing all the graphs by
+// default), each starting from the current settings
+bool
+initPanes()
+{
+  Pane def;
+  savePane(def);
+  def.x = def.y = def.width = def.height = 0;
+
+  if(paneSpecs.empty())
+  {
+    for(vector<Graph>::iterator gi = graphs.begin(); gi != graphs.end(); ++gi)
+      def.shown.push_back(&*gi);
+    def.graph = def.shown.front();
+    panes.push_back(def);
+  }
+
+  for(vector<const char*>::iterator it = paneSpecs.begin();
+      it != paneSpecs.end(); ++it)
+  {
+    Pane p = def;
+    if(parsePane(p, *it)) return true;
+    panes.push_back(p);
+  }
+
+  pane = 0;
+  loadPane(panes[0]);
+  return false;
+}
+
+
+// Initialize globals through command line
+int
+parseOptions(int argc, char* const argv[])
 {
   // starting options
   memcpy(backCol, Trend::backCol, sizeof(backCol));
@@ -2021,7 +3318,8 @@ parseOptions(int argc, char* const argv[])
   grSpec.x.mayor = grSpec.y.mayor = Trend::mayor;
 
   int arg;
-  while((arg = getopt(argc, argv, "dDSsvlmFgG:ht:A:E:R:I:M:N:T:L:irz:f:c:p:u:e")) != -1)
+  while((arg = getopt(argc, argv,
+	  "dDHSsvlPmFgG:ht:A:E:R:I:M:N:T:L:irz:f:c:p:u:ea:C:W:o:X:V:Y:Q:")) != -1)
     switch(arg)
     {
     case 'd':
@@ -2032,6 +3330,10 @@ parseOptions(int argc, char* const argv[])
       distrib = !distrib;
       break;
 
+    case 'H':
+      view = Trend::v_heatmap;
+      break;
+
     case 'S':
       smooth = !smooth;
       break;
@@ -2048,6 +3350,10 @@ parseOptions(int argc, char* const argv[])
       latency = !latency;
       break;
 
+    case 'P':
+      profiling = !profiling;
+      break;
+
     case 'm':
       marker = !marker;
       break;
@@ -2121,6 +3427,51 @@ parseOptions(int argc, char* const argv[])
       }
       break;
 
+    case 'a':
+      {
+	Input in;
+	if(!parseSource(in, optarg))
+	{
+	  cerr << argv[0] << ": bad input source\n";
+	  return -1;
+	}
+	inputs.push_back(in);
+      }
+      break;
+
+    case 'C':
+      ctlPath = optarg;
+      break;
+
+    case 'W':
+      recPath = optarg;
+      break;
+
+    case 'o':
+      parseSink(sinkPath, sinkDecimate, optarg);
+      break;
+
+    case 'X':
+      metricsAddr = optarg;
+      break;
+
+    case 'V':
+      videoPath = optarg;
+      break;
+
+    case 'Q':
+      if(parseSpectrum(specSize, specAverage, optarg))
+      {
+	cerr << argv[0] << ": bad spectrum size\n";
+	return -1;
+      }
+      spectrum = true;
+      break;
+
+    case 'Y':
+      paneSpecs.push_back(optarg);
+      break;
+
     case 'i':
       // TODO: deprecated
       input = Trend::incremental;
@@ -2153,7 +3504,9 @@ parseOptions(int argc, char* const argv[])
 
     case 'h':
       cout << argv[0] << " usage: " <<
-	argv[0] << " [options] <fifo|-> <hist-spec|hist-sz x-sz> [-y +y]\n" <<
+	argv[0] << " [options] [--bench[=frames]] [--snapshot=file[@N]] "
+	"[--size=WxH] [--soft] [--text[=braille|block]] <fifo|-> "
+	"<hist-spec|hist-sz x-sz> [-y +y]\n" <<
 	argv[0] << " version: " << TREND_VERSION << "\n";
       return 1;
 
@@ -2169,10 +3522,24 @@ parseOptions(int argc, char* const argv[])
     return -1;
   }
 
-  // fifo
-  fileName = argv[optind++];
-  if(!strcmp(fileName, "-"))
-    *const_cast<char*>(fileName) = 0;
+  // fifo (followed by additional sources)
+  Input in;
+  in.name = argv[optind++];
+  in.count = (graphs.size()? graphs.size(): 1);
+  in.input = input;
+  inputs.insert(inputs.begin(), in);
+
+  size_t count = 0;
+  for(vector<Input>::iterator it = inputs.begin(); it != inputs.end(); ++it)
+  {
+    if(!it->count)
+    {
+      it->count = 1;
+      it->input = input;
+    }
+    count += it->count;
+  }
+  graphs.resize(count);
 
   // history/divisions
   if(argc == 2 || argc == 4)
@@ -2213,10 +3580,67 @@ parseOptions(int argc, char* const argv[])
   else
     autoLimit = true;
 
+  // panes (starting from the settings above)
+  if(initPanes())
+  {
+    cerr << argv[0] << ": bad pane spec\n";
+    return -1;
+  }
+
   return 0;
 }
 
 
+// Extract the headless options (not handled by getopt) from the command line:
+// --bench[=frames], --snapshot=file[@N], --size=WxH, --soft and --text[=style]
+bool
+parseHeadless(int& argc, char* argv[])
+{
+  for(int i = 1; i < argc && strcmp(argv[i], "--"); ++i)
+  {
+    const char* arg = argv[i];
+    if(!strcmp(arg, "--bench"))
+      benchFrames = Trend::benchFrames;
+    else if(!strncmp(arg, "--bench=", 8))
+    {
+      if(!(benchFrames = strtoul(arg + 8, NULL, 10)))
+	return true;
+    }
+    else if(!strncmp(arg, "--snapshot=", 11))
+    {
+      parseSink(snapPath, snapEvery, arg + 11);
+      if(snapPath.empty())
+	return true;
+    }
+    else if(!strcmp(arg, "--soft"))
+      softRender = true;
+    else if(!strcmp(arg, "--text") || !strcmp(arg, "--text=braille"))
+      textMode = true;
+    else if(!strcmp(arg, "--text=block"))
+    {
+      textMode = true;
+      textStyle = Canvas::s_block;
+    }
+    else if(!strncmp(arg, "--size=", 7))
+    {
+      if(sscanf(arg + 7, "%dx%d", &offWidth, &offHeight) != 2 ||
+	  offWidth <= 0 || offHeight <= 0)
+	return true;
+    }
+    else
+      continue;
+
+    memmove(argv + i, argv + i + 1, (argc - i) * sizeof(*argv));
+    --argc;
+    --i;
+  }
+
+  headless = (benchFrames || snapPath.size() || textMode);
+  lockstep = (snapPath.size() && !benchFrames);
+  return false;
+}
+
+
 void
 setMode(mode_t mode)
 {
@@ -2254,10 +3678,11 @@ initGraphs()
   for(vector<Graph>::iterator gi = graphs.begin(); gi != graphs.end(); ++gi)
   {
     gi->rrData = new rr<Value>(history);
+    rings.push_back(gi->rrData);
     gi->rrBuf = new Value[history];
     gi->rrEnd = gi->rrBuf + history;
-    gi->rrPos = 0;
     rrFill(*gi, NAN);
+    gi->rrPos = gi->rrData->position();
 
     size_t n = gi - graphs.begin();
     gi->zero = (zeros.size() > n? zeros[n]: 0.);
@@ -2272,6 +3697,7 @@ initGraphs()
 
     if(gi->label.size() > maxLabel)
       maxLabel = gi->label.size();
+    exportLabels.push_back(new string(gi->label));
 
     if(lineCol.size() > n && lineCol[n].size())
       parseColor(gi->lineCol, lineCol[n].c_str());
@@ -2281,25 +3707,452 @@ initGraphs()
 }
 
 
+// flush the video output (while the GL context is still current)
+void
+closeVideo()
+{
+  if(!video) return;
+  video->finish();
+  delete video;
+  video = NULL;
+}
+
+
+// Select the renderer of the headless modes: an offscreen GL context, unless
+// the software rasterizer is requested (or the context can't be created)
+void
+openRenderer(Offscreen& ctx, const char* prg)
+{
+  static GLDraw gl;
+  if(!softRender)
+  {
+    if(ctx.open(offWidth, offHeight))
+    {
+      draw = &gl;
+      return;
+    }
+    cerr << prg << ": cannot create an offscreen GL context, "
+      "rendering in software\n";
+  }
+
+  draw = soft = new SoftDraw;
+}
+
+
+// Render a fixed number of frames offscreen, as fast as possible, and print
+// the frame and ingest rates with the stage timings in key=value form
+int
+bench(const char* prg)
+{
+  Offscreen ctx;
+  openRenderer(ctx, prg);
+  reshape(offWidth, offHeight);
+  init();
+
+  const uint64_t samples = __atomic_load_n(&stats.samples, __ATOMIC_RELAXED);
+  const uint64_t start = monotonic();
+  for(size_t i = 0; i != benchFrames; ++i)
+  {
+    execute();
+    check();
+    display();
+  }
+  const double secs = (monotonic() - start) / 1e9;
+  closeVideo();
+
+  printf("frames=%lu width=%d height=%d renderer=%s graphs=%lu seconds=%.3f "
+      "fps=%.1f samples=%lu ingest=%.0f overruns=%lu\n",
+      static_cast<unsigned long>(benchFrames), winWidth, winHeight,
+      (soft? "soft": "gl"),
+      static_cast<unsigned long>(graphs.size()), secs, benchFrames / secs,
+      static_cast<unsigned long>(
+	__atomic_load_n(&stats.samples, __ATOMIC_RELAXED) - samples),
+      (__atomic_load_n(&stats.samples, __ATOMIC_RELAXED) - samples) / secs,
+      static_cast<unsigned long>(
+	__atomic_load_n(&stats.overruns, __ATOMIC_RELAXED)));
+
+  for(size_t i = 0; i != Profile::stages; ++i)
+  {
+    Profile::stage_t stage = static_cast<Profile::stage_t>(i);
+    Histogram::Summary s = profile.take(stage);
+    printf("stage=%s n=%lu p50=%.1f p99=%.1f max=%.1f\n",
+	Profile::name(stage), static_cast<unsigned long>(s.count),
+	s.p50 / 1e3, s.p99 / 1e3, s.max / 1e3);
+  }
+
+  return Trend::success;
+}
+
+
+void
+writeSnapshot(const unsigned char* rgb, uint64_t n, const char* prg)
+{
+  char buf[PATH_MAX];
+  imageName(buf, sizeof(buf), snapPath.c_str(), n);
+  if(!writeImage(buf, winWidth, winHeight, rgb))
+    cerr << prg << ": cannot write snapshot " << buf << "\n";
+}
+
+
+// write the oldest snapshot read back, if complete (or waiting for it)
+bool
+writeSnapshot(Readback& rb, bool wait, const char* prg)
+{
+  uint64_t n;
+  const unsigned char* rgb = rb.map(wait, n);
+  if(!rgb) return false;
+
+  writeSnapshot(rgb, n, prg);
+  rb.unmap();
+  return true;
+}
+
+
+// Render the input offscreen until exhausted, writing a snapshot every
+// snapEvery frames of the current graph and at the end
+int
+snapshot(const char* prg)
+{
+  Offscreen ctx;
+  openRenderer(ctx, prg);
+  reshape(offWidth, offHeight);
+  init();
+
+  // software frames are written directly
+  Readback* rb = (soft? NULL:
+      new Readback(winWidth, winHeight, Trend::readbackDepth));
+  vector<unsigned char> rgb(soft? soft->size(): 0);
+  size_t last = graph->rrPos;
+  unsigned long n = 0;
+
+  for(bool done = false; !done;)
+  {
+    // the producer waits for each update to be copied
+    pthread_mutex_lock(&mutex);
+    while(!damaged && !finished)
+      pthread_cond_wait(&synced, &mutex);
+    done = !damaged;
+    pthread_mutex_unlock(&mutex);
+
+    execute();
+    check();
+
+    if(done? (!n || graph->rrPos != last):
+	(snapEvery && graph->rrPos - last >= snapEvery))
+    {
+      display();
+      if(soft)
+      {
+	soft->read(&rgb[0]);
+	writeSnapshot(&rgb[0], n++, prg);
+      }
+      else
+      {
+	if(rb->full()) writeSnapshot(*rb, true, prg);
+	rb->start(n++);
+      }
+      last = graph->rrPos;
+    }
+
+    // write the snapshots completed meanwhile
+    while(rb && writeSnapshot(*rb, false, prg));
+  }
+
+  if(rb)
+  {
+    while(!rb->empty())
+      writeSnapshot(*rb, true, prg);
+    delete rb;
+  }
+  closeVideo();
+  return Trend::success;
+}
+
+
+/*
+ * Text mode
+ */
+
+uint32_t
+textColor(const GLfloat* c)
+{
+  return ((static_cast<uint32_t>(c[0] * 255.) << 16) |
+      (static_cast<uint32_t>(c[1] * 255.) << 8) |
+      static_cast<uint32_t>(c[2] * 255.));
+}
+
+
+// text canvas output of walkLine (shading is not supported)
+struct TextLine
+{
+  Canvas* canvas;
+  uint32_t rgb;
+  double sx;
+  double sy;
+  bool joined;
+  int n;
+  int px;
+  int py;
+
+  void shade(double) {}
+  void strip() { joined = true; n = 0; }
+  void lines() { joined = false; n = 0; }
+  void end() {}
+
+  void
+  vertex(double x, double y)
+  {
+    // clamp to just outside the canvas
+    double h = canvas->height();
+    int cx = lround(x * sx);
+    int cy = lround(std::max(-1., std::min(h, (hiLimit - y) * sy)));
+    if(n++ && (joined || !(n & 1)))
+      canvas->line(px, py, cx, cy, rgb);
+    px = cx;
+    py = cy;
+  }
+};
+
+
+size_t
+textLine(Canvas& c, const Graph& g, double sx, double sy)
+{
+  const LineSpec spec = {history, offset, divisions, g.rrPos, scroll, dimmed};
+  TextLine out = {&c, textColor(g.lineCol), sx, sy, false, 0, 0, 0};
+  return walkLine(g.rrBuf, g.rrEnd, spec, out);
+}
+
+
+// dotted grid (major lines only)
+void
+textGrid(Canvas& c, double sx, double sy)
+{
+  const uint32_t rgb = textColor(gridCol);
+  const int w = c.width();
+  const int h = c.height();
+
+  if(grSpec.x.mayor)
+  {
+    const double res = grSpec.x.res * grSpec.x.mayor;
+    if(divisions / res < w / Trend::maxGridDens)
+      for(double it = res; it <= divisions; it += res)
+      {
+	int x = lround((scroll? divisions - it + res: it) * sx);
+	for(int y = 0; y < h; y += 2)
+	  c.dot(x, y, rgb);
+      }
+  }
+
+  if(grSpec.y.mayor)
+  {
+    const double res = grSpec.y.res * grSpec.y.mayor;
+    if((hiLimit - loLimit) / res < h / Trend::maxGridDens)
+    {
+      double it = loLimit - fmod(loLimit, res);
+      if(it <= loLimit) it += res;
+      for(; it < hiLimit; it += res)
+      {
+	int y = lround((hiLimit - it) * sy);
+	for(int x = 0; x < w; x += 2)
+	  c.dot(x, y, rgb);
+      }
+    }
+  }
+}
+
+
+// vertical line at x (dotted when "step" is 2)
+void
+textVLine(Canvas& c, double x, double sx, int step, uint32_t rgb)
+{
+  int cx = lround(x * sx);
+  for(int y = 0; y < c.height(); y += step)
+    c.dot(cx, y, rgb);
+}
+
+
+// draw the graphs on the canvas (the last line is left for the status)
+void
+textDisplay(Canvas& c)
+{
+  c.clear();
+  if(c.lines() < 2 || c.columns() < 2)
+    return;
+
+  const double sx = (c.width() - 1.) / divisions;
+  const double sy = (c.height() - (c.height() / c.lines()) - 1.) /
+    (hiLimit - loLimit);
+
+  if(grid) textGrid(c, sx, sy);
+
+  // marks (see drawMarks)
+  for(deque<pair<size_t, size_t> >::const_iterator it = marks.begin();
+      it != marks.end(); ++it)
+  {
+    const Graph& g = graphs[it->first];
+    if(it->second > g.rrPos || g.rrPos - it->second >= history)
+      continue;
+
+    size_t i = offset + history - (g.rrPos - it->second);
+    size_t x = (scroll? i: it->second) % divisions;
+    textVLine(c, (x? x: divisions), sx, 2, textColor(markCol));
+  }
+
+  // graphs (the current one on top)
+  if(view != Trend::v_hide)
+  {
+    for(vector<Graph*>::iterator gi = shown.begin(); gi != shown.end(); ++gi)
+      if(*gi != graph)
+	textLine(c, **gi, sx, sy);
+  }
+  size_t pos = textLine(c, *graph, sx, sy);
+  if(marker && !scroll)
+    textVLine(c, pos, sx, 1, textColor(markCol));
+
+  // status line
+  char buf[256];
+  const Stats s = getStats();
+  int n = snprintf(buf, sizeof(buf), "%s: %g [%g, %g]", graph->label.c_str(),
+      graph->rrBuf[history - 1], loLimit, hiLimit);
+  if(latency && n > 0 && static_cast<size_t>(n) < sizeof(buf))
+    snprintf(buf + n, sizeof(buf) - n, " in: %lu ovr: %lu err: %lu",
+	static_cast<unsigned long>(s.samples),
+	static_cast<unsigned long>(s.overruns),
+	static_cast<unsigned long>(s.errors));
+  c.text(0, c.lines() - 1, buf, textColor(textCol));
+}
+
+
+void
+textSignal(int sig)
+{
+  if(sig == SIGWINCH)
+    textResized = true;
+  else
+    textQuit = true;
+}
+
+
+bool
+textWrite(const string& out)
+{
+  for(size_t pos = 0; pos != out.size();)
+  {
+    ssize_t n = write(STDOUT_FILENO, out.data() + pos, out.size() - pos);
+    if(n > 0) pos += n;
+    else if(n < 0 && errno != EINTR && errno != EAGAIN)
+      return false;
+  }
+
+  return true;
+}
+
+
+// Draw on the terminal at a limited rate, only when changed, until
+// interrupted
+int
+text(const char* prg)
+{
+  struct sigaction sa;
+  memset(&sa, 0, sizeof(sa));
+  sa.sa_handler = textSignal;
+  sigaction(SIGWINCH, &sa, NULL);
+  sigaction(SIGINT, &sa, NULL);
+  sigaction(SIGTERM, &sa, NULL);
+  sigaction(SIGHUP, &sa, NULL);
+
+  // alternate screen, hidden cursor
+  if(!textWrite("\033[?1049h\033[?25l"))
+  {
+    cerr << prg << ": cannot write to the terminal\n";
+    return Trend::fail;
+  }
+
+  Canvas canvas(textStyle);
+  const long ns = 1000000000L / Trend::textRate;
+  const timespec ts = {ns / 1000000000L, ns % 1000000000L};
+  string out;
+
+  while(!textQuit)
+  {
+    if(textResized)
+    {
+      textResized = false;
+      winsize ws;
+      if(ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) || !ws.ws_col || !ws.ws_row)
+      {
+	ws.ws_col = Trend::textCols;
+	ws.ws_row = Trend::textRows;
+      }
+      canvas.resize(ws.ws_col, ws.ws_row);
+      dirty = true;
+    }
+
+    execute();
+    if(!paused) check();
+    if(dirty)
+    {
+      dirty = false;
+      textDisplay(canvas);
+      out.clear();
+      canvas.render(out);
+      if(!textWrite(out)) break;
+    }
+
+    nanosleep(&ts, NULL);
+  }
+
+  textWrite("\033[0m\033[?25h\033[?1049l");
+  return Trend::success;
+}
+
+
 int
 main(int argc, char* argv[]) try
 {
   // parameters
-  glutInit(&argc, argv);
+  if(parseHeadless(argc, argv))
+  {
+    cerr << argv[0] << ": bad headless option\n";
+    return Trend::args;
+  }
+  if(!headless)
+    glutInit(&argc, argv);
   if(parseOptions(argc, argv))
     return Trend::args;
 
   // initialize rr buffers
-  if(!graphs.size()) graphs.resize(1);
-  graph = &graphs[0];
   initGraphs();
 
   // start the producer thread
   pthread_t thrd;
   pthread_mutex_init(&mutex, NULL);
+  pthread_cond_init(&synced, NULL);
   pthread_create(&thrd, NULL, producer, argv[0]);
+  if(metricsAddr)
+    pthread_create(&thrd, NULL, exporter, argv[0]);
+  // frames are captured from the first redraw
+  if(videoPath && !textMode)
+  {
+    video = new Video(videoPath, Trend::videoRate, &stats);
+    if(!video->open())
+    {
+      cerr << argv[0] << ": cannot write video to " << videoPath << "\n";
+      delete video;
+      video = NULL;
+    }
+  }
+
+  if(benchFrames)
+    return bench(argv[0]);
+  if(snapPath.size())
+    return snapshot(argv[0]);
+  if(textMode)
+    return text(argv[0]);
 
   // display, main mindow and callbacks
+  GLDraw gl(true);
+  draw = &gl;
   glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGB);
   glutCreateWindow(title? title: argv[0]);
   glutReshapeFunc(reshape);
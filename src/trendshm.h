@@ -0,0 +1,127 @@
+/*
+ * trendshm: shared-memory ring layout for trend producers
+ * Copyright(c) 2018 by wave++ "Yuri D'Elia" <wavexx@thregr.org>
+ * Distributed under GNU LGPL WITHOUT ANY WARRANTY.
+ */
+
+#ifndef trendshm_h
+#define trendshm_h
+
+/*
+ * A POSIX shared-memory object (see shm_open(3)) containing a header
+ * followed by a round-robin buffer of frames. Each frame contains "columns"
+ * native doubles (one for each graph). The semantics are the same as trend's
+ * internal round-robin: frame number "pos" is stored in slot "pos % size",
+ * and "pos" counts all the frames ever written. The newest "size" frames can
+ * thus be snapshotted by copying slots [pos % size, size) followed by
+ * [0, pos % size), exactly like rr::copy().
+ *
+ * The writer stores the whole frame first, then publishes it by incrementing
+ * "pos" with release semantics. Readers load "pos" with acquire semantics,
+ * copy the frames they need, issue an acquire fence and load "pos" again (as
+ * in a seqlock). While frame "pos" is being stored, its slot still holds frame
+ * (pos - size): only the frames from (pos - size + 1) on, as of the second
+ * load, are intact, and the older ones are discarded. The ring thus holds at
+ * least two frames. There is a single writer for each object.
+ *
+ * A restarting writer re-creates the object in place (truncating it, possibly
+ * with a different layout): readers check the length of the object and the
+ * header against the layout they mapped, and map it again when they differ.
+ *
+ * Writers use:
+ *
+ *   struct trend_shm* shm = trend_shm_create("/name", columns, size);
+ *   ...
+ *   trend_shm_push(shm, frame);
+ *
+ * and trend reads the object with "shm:/name".
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#define TREND_SHM_MAGIC 0x544e5254u /* "TRNT" */
+#define TREND_SHM_VERSION 1u
+
+struct trend_shm
+{
+  uint32_t magic;	/* TREND_SHM_MAGIC */
+  uint32_t version;	/* TREND_SHM_VERSION */
+  uint32_t columns;	/* doubles per frame */
+  uint32_t size;	/* frames in the ring */
+  uint64_t pos;		/* frames written so far (atomic) */
+  uint64_t reserved[5];	/* pad the header to 64 bytes */
+};
+
+
+/* total object length */
+static inline size_t
+trend_shm_length(uint32_t columns, uint32_t size)
+{
+  return sizeof(struct trend_shm) + sizeof(double) * columns * size;
+}
+
+
+/* frame data */
+static inline double*
+trend_shm_data(const struct trend_shm* shm)
+{
+  return (double*)(shm + 1);
+}
+
+
+/* create (or replace) and map a new ring of at least 2 frames, NULL on
+ * error */
+static inline struct trend_shm*
+trend_shm_create(const char* name, uint32_t columns, uint32_t size)
+{
+  size_t len = trend_shm_length(columns, size);
+  struct trend_shm* shm;
+  void* map;
+  int fd;
+
+  if(!columns || size < 2) return NULL;
+  if((fd = shm_open(name, O_RDWR | O_CREAT | O_TRUNC, 0644)) < 0)
+    return NULL;
+  if(ftruncate(fd, len))
+  {
+    close(fd);
+    return NULL;
+  }
+
+  map = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if(map == MAP_FAILED) return NULL;
+
+  shm = (struct trend_shm*)map;
+  shm->columns = columns;
+  shm->size = size;
+  shm->pos = 0;
+  shm->version = TREND_SHM_VERSION;
+  __atomic_store_n(&shm->magic, TREND_SHM_MAGIC, __ATOMIC_RELEASE);
+  return shm;
+}
+
+
+/* publish a new frame of "columns" values */
+static inline void
+trend_shm_push(struct trend_shm* shm, const double* frame)
+{
+  uint64_t pos = shm->pos;
+  memcpy(trend_shm_data(shm) + (pos % shm->size) * shm->columns, frame,
+      sizeof(double) * shm->columns);
+  __atomic_store_n(&shm->pos, pos + 1, __ATOMIC_RELEASE);
+}
+
+
+/* unmap the ring (the object itself is removed with shm_unlink) */
+static inline void
+trend_shm_close(struct trend_shm* shm)
+{
+  munmap(shm, trend_shm_length(shm->columns, shm->size));
+}
+
+#endif
@@ -0,0 +1,308 @@
+/*
+ * video: live export of the rendered frames - implementation
+ * Copyright(c) 2018 by wave++ "Yuri D'Elia" <wavexx@thregr.org>
+ * Distributed under GNU LGPL WITHOUT ANY WARRANTY.
+ */
+
+/*
+ * Headers
+ */
+
+// interface
+#include "video.hh"
+using std::string;
+using std::vector;
+
+// c system headers
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/stat.h>
+
+
+/*
+ * Implementation
+ */
+
+namespace
+{
+  // signal an eventfd
+  void
+  post(int fd)
+  {
+    uint64_t one = 1;
+    ssize_t ret = write(fd, &one, sizeof(one));
+    (void)ret;
+  }
+}
+
+
+Video::Video(const string& path, int rate, Stats* stats)
+: path(path), rate(rate), stats(stats), width(0), height(0), len(0), rb(NULL),
+  seq(0), reserved(0), wake(-1), stop(false), started(false), full(Trend::videoFrames),
+  empty(Trend::videoFrames)
+{
+  y4m = (path.size() >= 4 &&
+      !strcasecmp(path.c_str() + path.size() - 4, ".y4m"));
+}
+
+
+Video::~Video()
+{
+  if(started)
+  {
+    __atomic_store_n(&stop, true, __ATOMIC_RELEASE);
+    post(wake);
+    pthread_join(thread, NULL);
+  }
+
+  delete rb;
+  if(wake >= 0) ::close(wake);
+}
+
+
+bool
+Video::open()
+{
+  if((wake = eventfd(0, EFD_CLOEXEC)) < 0)
+    return false;
+
+  // the output itself is opened by the writer
+  if(pthread_create(&thread, NULL, run, this))
+    return false;
+
+  started = true;
+  return true;
+}
+
+
+// pass the completed frames to the writer, if buffers are available
+void
+Video::collect(bool wait)
+{
+  uint64_t tag;
+  const unsigned char* rgb;
+  while((rgb = rb->map(wait, tag)))
+  {
+    size_t i;
+    if(!empty.pop(i))
+      __atomic_add_fetch(&stats->vidDrops, 1, __ATOMIC_RELAXED);
+    else
+    {
+      memcpy(frame(i), rgb, len);
+      full.push(i);
+      post(wake);
+    }
+
+    rb->unmap();
+  }
+}
+
+
+// the size is fixed by the first frame
+void
+Video::setup(int width, int height)
+{
+  this->width = width;
+  this->height = height;
+  len = static_cast<size_t>(width) * height * 3;
+  frames.resize(Trend::videoFrames * len);
+  for(size_t i = 0; i != static_cast<size_t>(Trend::videoFrames); ++i)
+    empty.push(i);
+}
+
+
+void
+Video::capture(int width, int height)
+{
+  if(!rb)
+  {
+    if(!len) setup(width, height);
+    rb = new Readback(this->width, this->height, Trend::readbackDepth);
+  }
+
+  collect(false);
+  if(width != this->width || height != this->height || rb->full())
+    __atomic_add_fetch(&stats->vidDrops, 1, __ATOMIC_RELAXED);
+  else
+    rb->start(seq++);
+}
+
+
+unsigned char*
+Video::reserve(int width, int height)
+{
+  if(!len) setup(width, height);
+  if(width != this->width || height != this->height || !empty.pop(reserved))
+  {
+    __atomic_add_fetch(&stats->vidDrops, 1, __ATOMIC_RELAXED);
+    return NULL;
+  }
+
+  return frame(reserved);
+}
+
+
+void
+Video::commit()
+{
+  full.push(reserved);
+  post(wake);
+}
+
+
+void
+Video::finish()
+{
+  if(rb) collect(true);
+}
+
+
+void*
+Video::run(void* arg)
+{
+  // write errors are handled directly
+  sigset_t set;
+  sigemptyset(&set);
+  sigaddset(&set, SIGPIPE);
+  pthread_sigmask(SIG_BLOCK, &set, NULL);
+
+  static_cast<Video*>(arg)->work();
+  return NULL;
+}
+
+
+// flip (and convert to planar BT.601 YCbCr for y4m) a frame
+void
+Video::convert(const unsigned char* rgb, vector<unsigned char>& out)
+{
+  const size_t stride = static_cast<size_t>(width) * 3;
+  const size_t pixels = static_cast<size_t>(width) * height;
+
+  if(!y4m)
+  {
+    out.resize(len);
+    for(int y = 0; y != height; ++y)
+      memcpy(&out[y * stride], rgb + (height - 1 - y) * stride, stride);
+    return;
+  }
+
+  static const char tag[] = "FRAME\n";
+  const size_t hdr = sizeof(tag) - 1;
+  out.resize(hdr + pixels * 3);
+  memcpy(&out[0], tag, hdr);
+
+  unsigned char* Y = &out[hdr];
+  unsigned char* Cb = Y + pixels;
+  unsigned char* Cr = Cb + pixels;
+  for(int y = 0; y != height; ++y)
+  {
+    const unsigned char* p = rgb + (height - 1 - y) * stride;
+    for(int x = 0; x != width; ++x, p += 3)
+    {
+      const int r = p[0], g = p[1], b = p[2];
+      *Y++ = ((66 * r + 129 * g + 25 * b + 128) >> 8) + 16;
+      *Cb++ = ((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128;
+      *Cr++ = ((112 * r - 94 * g - 18 * b + 128) >> 8) + 128;
+    }
+  }
+}
+
+
+// write a whole buffer to the non-blocking output, waiting for it to drain
+// until stopped (the eventfd is also polled, its posts being only a hint)
+bool
+Video::writeAll(int fd, const unsigned char* buf, size_t len)
+{
+  for(size_t pos = 0; pos != len;)
+  {
+    ssize_t n = ::write(fd, buf + pos, len - pos);
+    if(n > 0) pos += n;
+    else if(n < 0 && errno != EAGAIN && errno != EINTR)
+      return false;
+    else if(n < 0 && errno == EAGAIN)
+    {
+      if(__atomic_load_n(&stop, __ATOMIC_ACQUIRE))
+	return false;
+
+      pollfd fds[2] = {{fd, POLLOUT, 0}, {wake, POLLIN, 0}};
+      if(poll(fds, 2, -1) < 0 && errno != EINTR)
+	return false;
+      if(fds[1].revents & POLLIN)
+      {
+	uint64_t ev;
+	ssize_t ret = ::read(wake, &ev, sizeof(ev));
+	(void)ret;
+      }
+    }
+  }
+
+  return true;
+}
+
+
+void
+Video::work()
+{
+  vector<unsigned char> out;
+  int fd = -1;
+  bool fifo = true;
+  for(;;)
+  {
+    size_t i;
+    if(!full.pop(i))
+    {
+      if(__atomic_load_n(&stop, __ATOMIC_ACQUIRE))
+	break;
+
+      uint64_t n;
+      if(::read(wake, &n, sizeof(n)) < 0 && errno != EINTR)
+	break;
+      continue;
+    }
+
+    convert(frame(i), out);
+    empty.push(i);
+
+    // (re)open the output as needed (only fifos can be re-opened), starting
+    // each stream with its header: without a reader, the frame is dropped
+    struct stat stBuf;
+    if(fd < 0 && fifo &&
+	(fd = ::open(path.c_str(),
+	    O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC | O_NONBLOCK, 0644)) >= 0)
+    {
+      fifo = (!fstat(fd, &stBuf) && S_ISFIFO(stBuf.st_mode));
+
+      char hdr[128];
+      int n = snprintf(hdr, sizeof(hdr),
+	  "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C444\n", width, height, rate);
+      if(y4m && !writeAll(fd, reinterpret_cast<unsigned char*>(hdr), n))
+      {
+	::close(fd);
+	fd = -1;
+      }
+    }
+
+    if(fd < 0)
+    {
+      __atomic_add_fetch(&stats->vidDrops, 1, __ATOMIC_RELAXED);
+      continue;
+    }
+    if(writeAll(fd, &out[0], out.size()))
+      __atomic_add_fetch(&stats->vidFrames, 1, __ATOMIC_RELAXED);
+    else
+    {
+      // fifos are re-opened for the next reader
+      ::close(fd);
+      fd = -1;
+    }
+  }
+
+  if(fd >= 0) ::close(fd);
+}
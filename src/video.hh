@@ -0,0 +1,84 @@
+/*
+ * video: live export of the rendered frames
+ * Copyright(c) 2018 by wave++ "Yuri D'Elia" <wavexx@thregr.org>
+ * Distributed under GNU LGPL WITHOUT ANY WARRANTY.
+ */
+
+#ifndef video_hh
+#define video_hh
+
+// defaults
+#include "offscreen.hh"
+#include "input.hh"
+#include "queue.hh"
+
+// system headers
+#include <string>
+#include <vector>
+
+// c system headers
+#include <pthread.h>
+
+
+/*
+ * Raw RGB or YUV4MPEG2 (".y4m", 4:4:4) stream of the rendered frames, to a
+ * file or fifo. Frames are read back asynchronously, copied to a fixed set of
+ * buffers and converted/written by a background thread: whenever the readback
+ * ring or the buffers are full, frames are dropped instead of stalling the
+ * display (and, in turn, the input). The frame size is fixed by the first
+ * frame: frames of a different size (after resizing) are dropped. Frames
+ * rendered in memory (by the software rasterizer) skip the readback.
+ */
+class Video
+{
+  std::string path;
+  bool y4m;
+  int rate;
+  Stats* stats;
+  int width;
+  int height;
+  size_t len;
+  Readback* rb;
+  uint64_t seq;
+  size_t reserved;
+  int wake;
+  bool stop;
+  bool started;
+  pthread_t thread;
+  std::vector<unsigned char> frames;
+  Queue<size_t> full;
+  Queue<size_t> empty;
+
+  unsigned char*
+  frame(size_t i)
+  {
+    return &frames[i * len];
+  }
+
+  void setup(int width, int height);
+  void collect(bool wait);
+  static void* run(void* arg);
+  void work();
+  bool writeAll(int fd, const unsigned char* buf, size_t len);
+  void convert(const unsigned char* rgb, std::vector<unsigned char>& out);
+
+public:
+  // the rate (frames per second) is only nominal, for the y4m header
+  Video(const std::string& path, int rate, Stats* stats);
+  ~Video();
+
+  bool open();
+
+  // queue the current color buffer (from the GL thread)
+  void capture(int width, int height);
+
+  // a buffer for a frame rendered in memory (RGB, bottom row first), NULL if
+  // the frame has to be dropped; queue it with commit()
+  unsigned char* reserve(int width, int height);
+  void commit();
+
+  // pass the frames still being read back to the writer (from the GL thread)
+  void finish();
+};
+
+#endif